@@ -0,0 +1,226 @@
+// Замер AnalyzeLog по частям на синтетическом логе: чтение, разбор, -s, -w и вывод 5xx
+// считаются отдельными таймерами в одном проходе, результат печатается в JSON.
+// analyzelog_bench [--size=1G] [--errors=0.05] [--urls=5000] [--skew=0] [--seed=239]
+//                  [--log=analyzelog_bench.log] [--reuse] [--output=/dev/null] [--json=file]
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_generator.h"
+#include "../lib/histogram.h"
+#include "../lib/mapped_file.h"
+#include "../lib/output_writer.h"
+#include "../lib/parser.h"
+#include "../lib/request_counter.h"
+#include "../lib/window.h"
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+struct BenchArgs {
+    LogGeneratorOptions generator;
+    std::string log_path = "analyzelog_bench.log";
+    std::string output_path = "/dev/null";
+    std::string json_path;
+    bool reuse = false; // не генерировать, если файл уже есть
+};
+
+bool read_args(BenchArgs &args, int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq == std::string::npos ? arg.size() : eq + 1);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (name == "--size=") {
+            args.generator.bytes = parse_size(value);
+            if (args.generator.bytes == 0) {
+                return false;
+            }
+        } else if (name == "--errors=") {
+            args.generator.error_ratio = atof(value.c_str());
+        } else if (name == "--urls=") {
+            args.generator.urls = atoi(value.c_str());
+        } else if (name == "--skew=") {
+            args.generator.skew = atoi(value.c_str());
+        } else if (name == "--seed=") {
+            args.generator.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "--log=") {
+            args.log_path = value;
+        } else if (name == "--output=") {
+            args.output_path = value;
+        } else if (name == "--json=") {
+            args.json_path = value;
+        } else if (name == "--reuse") {
+            args.reuse = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Phase {
+    const char *name;
+    double seconds = 0;
+};
+
+int main(int argc, char *argv[]) {
+    BenchArgs args;
+    if (!read_args(args, argc, argv)) {
+        fprintf(stderr, "usage: analyzelog_bench [--size=1G] [--errors=0.05] [--urls=5000] [--skew=0] [--seed=239]\n"
+                        "                        [--log=path] [--reuse] [--output=path] [--json=path]\n");
+        return 1;
+    }
+
+    Phase generate{"generate"};
+    LogGeneratorStats generated;
+    if (!args.reuse || !MappedFile(args.log_path.c_str()).is_open()) {
+        auto begin = Clock::now();
+        if (!generate_log(args.log_path.c_str(), args.generator, generated)) {
+            fprintf(stderr, "cannot write %s\n", args.log_path.c_str());
+            return 1;
+        }
+        generate.seconds = seconds_since(begin);
+    }
+
+    MappedFile in(args.log_path.c_str());
+    if (!in.is_open()) {
+        fprintf(stderr, "cannot read %s\n", args.log_path.c_str());
+        return 1;
+    }
+
+    // чтение без разбора: только поиск концов строк по отображённому файлу
+    Phase read{"read"};
+    uint64_t lines = 0;
+    {
+        auto begin = Clock::now();
+        LineReader reader(in.view());
+        std::string_view line;
+        while (reader.next(line)) {
+            lines++;
+        }
+        read.seconds = seconds_since(begin);
+    }
+
+    // строки разбираются пачками, и каждая пачка по очереди проходит через -s, -w и вывод,
+    // поэтому у каждой части свой таймер, а память не зависит от размера лога
+    Phase parse{"parse"};
+    Phase stats{"stats"};
+    Phase window{"window"};
+    Phase output{"output"};
+    const size_t batch_size = 1 << 16;
+    std::vector<log> batch;
+    std::vector<std::string_view> batch_lines;
+    batch.reserve(batch_size);
+    batch_lines.reserve(batch_size);
+    RequestCounter top;
+    TimeHistogram hist;
+    OutputWriter out;
+    out.open_file(args.output_path.c_str());
+    uint64_t errors = 0;
+    uint64_t checksum = 0;
+    LineReader reader(in.view());
+    bool more = true;
+    while (more) {
+        auto begin = Clock::now();
+        batch.clear();
+        batch_lines.clear();
+        std::string_view line;
+        while (batch.size() < batch_size && (more = reader.next(line))) {
+            log cur = parse_log(line);
+            if (cur.status == -9) {
+                continue;
+            }
+            batch.push_back(cur);
+            batch_lines.push_back(line);
+        }
+        auto parsed = Clock::now();
+        parse.seconds += std::chrono::duration<double>(parsed - begin).count();
+
+        for (const log &cur: batch) {
+            if (cur.status / 100 == 5) {
+                top.add(cur.request);
+            }
+        }
+        auto counted = Clock::now();
+        stats.seconds += std::chrono::duration<double>(counted - parsed).count();
+
+        for (const log &cur: batch) {
+            hist.add(cur.time);
+        }
+        auto windowed = Clock::now();
+        window.seconds += std::chrono::duration<double>(windowed - counted).count();
+
+        // тот же OutputWriter, что у ErrorWriter в main.cpp
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (batch[i].status / 100 == 5) {
+                out.add(batch_lines[i]);
+                errors++;
+            }
+        }
+        output.seconds += seconds_since(windowed);
+    }
+    {
+        auto begin = Clock::now();
+        out.flush();
+        output.seconds += seconds_since(begin);
+    }
+    {
+        auto begin = Clock::now();
+        for (const auto &[request, count]: top.top(10)) {
+            checksum += count + request.size();
+        }
+        stats.seconds += seconds_since(begin);
+    }
+    {
+        auto begin = Clock::now();
+        WindowSet windows({60, 3600});
+        for (const auto &[time, count]: hist.entries()) {
+            windows.add(time, count);
+        }
+        for (const WindowSet::Result &res: windows.results()) {
+            checksum += res.count + res.l;
+        }
+        window.seconds += seconds_since(begin);
+    }
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"log\": {\"path\": \"" << args.log_path << "\", \"bytes\": " << in.size() << ", \"lines\": " << lines
+         << ", \"errors\": " << errors << "},\n"
+         << "  \"generator\": {\"size\": " << args.generator.bytes << ", \"error_ratio\": "
+         << args.generator.error_ratio << ", \"urls\": " << args.generator.urls << ", \"skew\": "
+         << args.generator.skew << ", \"seed\": " << args.generator.seed << ", \"generated\": "
+         << (generated.lines ? "true" : "false") << "},\n"
+         << "  \"tokenizer\": \"" << tokenizer_name(best_tokenizer()) << "\",\n"
+         << "  \"phases\": {\n";
+    Phase phases[] = {generate, read, parse, stats, window, output};
+    for (size_t k = 0; k < std::size(phases); ++k) {
+        const Phase &p = phases[k];
+        double rate = p.seconds > 0 ? in.size() / p.seconds / 1e6 : 0;
+        json << "    \"" << p.name << "\": {\"seconds\": " << p.seconds << ", \"mb_per_sec\": "
+             << rate << ", \"ns_per_line\": " << (lines ? p.seconds * 1e9 / lines : 0) << "}"
+             << (k + 1 < std::size(phases) ? "," : "") << "\n";
+        fprintf(stderr, "%-8s %8.3f s %10.1f MB/sec\n", p.name, p.seconds, rate);
+    }
+    json << "  },\n"
+         << "  \"checksum\": " << checksum << "\n"
+         << "}\n";
+    if (args.json_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream(args.json_path) << json.str();
+    }
+    return 0;
+}
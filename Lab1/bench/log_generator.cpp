@@ -0,0 +1,113 @@
+#include "log_generator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char *kMonths[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+const char *kMethods[] = {"GET", "GET", "GET", "POST", "HEAD"};
+const long long kStart = 804571200; // 01/Jul/1995:00:00:00 -0400
+const int kZone = -4 * 3600;
+
+struct Random {
+    uint64_t state;
+
+    uint64_t next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t x = state;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // [0, 1)
+    double uniform() {
+        return (next() >> 11) * 0x1.0p-53;
+    }
+};
+
+// дни от 1970-01-01 -> год, месяц (1..12), день
+void civil_from_days(long long z, int &y, unsigned &m, unsigned &d) {
+    z += 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = unsigned(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    y = int(yoe + era * 400);
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y += m <= 2;
+}
+
+} // namespace
+
+bool generate_log(const char *path, const LogGeneratorOptions &options, LogGeneratorStats &stats) {
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        return false;
+    }
+    stats = {};
+    Random random{options.seed};
+    uint32_t urls = options.urls ? options.urls : 1;
+    uint32_t rate = options.lines_per_second ? options.lines_per_second : 1;
+    std::vector<char> buffer(1 << 20);
+    size_t used = 0;
+    bool ok = true;
+    while (stats.bytes < options.bytes && ok) {
+        long long time = kStart + stats.lines / rate;
+        if (options.skew > 0) {
+            time += (long long) (random.next() % (2 * options.skew + 1)) - options.skew;
+        }
+        long long local = time + kZone;
+        long long days = local >= 0 ? local / 86400 : (local - 86399) / 86400;
+        long long second = local - days * 86400;
+        int year;
+        unsigned month, day;
+        civil_from_days(days, year, month, day);
+
+        bool error = random.uniform() < options.error_ratio;
+        int status = error ? 500 + int(random.next() % 4) : (random.next() % 10 == 0 ? 304 : 200);
+        double x = random.uniform();
+        uint32_t url = uint32_t(x * x * urls);
+        uint64_t r = random.next();
+        char line[512];
+        int n = snprintf(line, sizeof(line),
+                         "host%u.example.com - - [%02u/%s/%04d:%02lld:%02lld:%02lld -0400] "
+                         "\"%s /shuttle/missions/sts-%u/mission.html HTTP/1.0\" %d %u\n",
+                         unsigned(r % 2000), day, kMonths[month - 1], year, second / 3600, second / 60 % 60,
+                         second % 60, kMethods[(r >> 16) % 5], url, status, unsigned((r >> 24) % 100000));
+        if (used + n > buffer.size()) {
+            ok = fwrite(buffer.data(), 1, used, out) == used;
+            used = 0;
+        }
+        memcpy(buffer.data() + used, line, n);
+        used += n;
+        stats.bytes += n;
+        stats.lines++;
+        stats.errors += error;
+    }
+    ok = ok && fwrite(buffer.data(), 1, used, out) == used;
+    ok = fclose(out) == 0 && ok;
+    return ok;
+}
+
+uint64_t parse_size(const std::string &text) {
+    char *end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (end == text.c_str() || value <= 0) {
+        return 0;
+    }
+    switch (*end) {
+        case 'K': case 'k': value *= 1 << 10; break;
+        case 'M': case 'm': value *= 1 << 20; break;
+        case 'G': case 'g': value *= 1 << 30; break;
+        case '\0': break;
+        default: return 0;
+    }
+    return uint64_t(value);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Детерминированный генератор Common Log Format: при одинаковых параметрах файл
+// получается байт в байт одинаковым, поэтому замеры на разных машинах сравнимы.
+struct LogGeneratorOptions {
+    uint64_t bytes = 1ull << 30;      // примерный размер, генерация останавливается после первой строки за ним
+    double error_ratio = 0.05;        // доля строк со статусом 5xx
+    uint32_t urls = 5000;             // число различных запросов; популярность убывает квадратично
+    uint32_t skew = 0;                // время строки сдвигается случайно на [-skew, skew] секунд
+    uint32_t lines_per_second = 10;   // средняя нагрузка
+    uint64_t seed = 239;
+};
+
+struct LogGeneratorStats {
+    uint64_t bytes = 0;
+    uint64_t lines = 0;
+    uint64_t errors = 0;
+};
+
+// пишет лог в path; false, если файл не открылся или запись не удалась
+bool generate_log(const char *path, const LogGeneratorOptions &options, LogGeneratorStats &stats);
+
+// "64K", "500M", "10G" -> байты; 0, если не разобралось
+uint64_t parse_size(const std::string &text);
@@ -0,0 +1,164 @@
+// Микробенчмарк разбора строк: прежний parse_log против tokenize_clf (scalar/sse2/avx2).
+// parser_bench [lines], по умолчанию 10M строк синтетического лога в памяти.
+#include <chrono>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../lib/mapped_file.h"
+#include "../lib/parser.h"
+
+// разбор, который был в main.cpp до tokenize_clf: время считается от 1 июля 1995 по позициям после '['
+log parse_log_legacy(std::string_view x) {
+    log ans;
+    ans.time = 807220800; // 1 july 1995
+    for (size_t i = 0; i < x.size(); ++i) {
+ 
+        if (x[i] == '[') {
+            if (i + 27 >= x.size() || x[i + 27] != ']') {
+                ans.status = -9;
+                return ans;
+            }
+            if (x[i + 1] == '0') {
+                ans.time += ((x[i + 2] - '0') - 1) * 24 * 60 * 60;
+            } else {
+                if (x[i + 1] - '0' < 0 || x[i + 1] - '0' > 9 || x[i + 2] - '0' < 0 || x[i + 2] - '0' > 9) {
+                    ans.status = -9;
+                    return ans;
+                }
+                ans.time += ((10 * (x[i + 1] - '0')) + (x[i + 2] - '0') - 1) * 24 * 60 * 60;
+            }
+ 
+            if (x[i + 13] == '0') {
+                ans.time += (x[i + 14] - '0') * 60 * 60;
+            } else {
+                if (x[i + 13] - '0' < 0 || x[i + 14] - '0' > 9 || x[i + 14] - '0' < 0 || x[i + 13] - '0' > 9) {
+                    ans.status = -9;
+                    return ans;
+                }
+                ans.time += ((10 * (x[i + 13] - '0')) + (x[i + 14] - '0') - 1) * 60 * 60;
+            }
+ 
+ 
+            if (x[i + 16] == '0') {
+                ans.time += (x[i + 17] - '0') * 60;
+            } else {
+ 
+                if (x[i + 16] - '0' < 0 || x[i + 16] - '0' > 9 || x[i + 17] - '0' < 0 || x[i + 17] - '0' > 9) {
+                    ans.status = -9;
+                    return ans;
+                }
+                ans.time += ((10 * (x[i + 16] - '0')) + (x[i + 17] - '0') - 1) * 60;
+            }
+ 
+ 
+            if (x[i + 19] == '0') {
+                ans.time += x[i + 20] - '0';
+            } else {
+ 
+                if (x[i + 19] - '0' < 0 || x[i + 19] - '0' > 5 || x[i + 20] - '0' < 0 || x[i + 20] - '0' > 9) {
+                    ans.status = -9;
+                    return ans;
+                }
+                ans.time += ((10 * (x[i + 19] - '0')) + (x[i + 20] - '0') - 1);
+            }
+ 
+ 
+            break;
+        }
+    }
+ 
+    // поля считаются с конца строки по пробелам: статус между последним и предпоследним,
+    // запрос - от четвёртого с конца пробела до второго (включительно)
+    int cnt = 0;
+    int spaces[4] = {-1, -1, -1, -1};
+    for (int i = x.size() - 1; i >= 0 && cnt < 4; --i) {
+        if (x[i] == ' ') {
+            spaces[cnt++] = i;
+        }
+    }
+    if (cnt < 2 || spaces[0] - spaces[1] <= 1) {
+        ans.status = -9;
+        return ans;
+    }
+    std::string_view st = x.substr(spaces[1] + 1, spaces[0] - spaces[1] - 1);
+    std::string_view rq = x.substr(spaces[3] + 1, spaces[1] - spaces[3]);
+    std::string_view namelog = x.substr(0, x.find(' '));
+
+    if (std::from_chars(st.data(), st.data() + st.size(), ans.status).ec != std::errc()) {
+        ans.status = -9;
+        return ans;
+    }
+    ans.request = rq;
+    ans.anlog = namelog;
+    return ans;
+}
+
+std::string make_log(long long lines) {
+    static const char *months[] = {"Jun", "Jul", "Aug"};
+    std::string text;
+    text.reserve(lines * 110);
+    uint64_t seed = 239;
+    char buf[256];
+    for (long long i = 0; i < lines; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t r = seed >> 33;
+        int status = r % 20 == 0 ? 500 + r % 4 : 200;
+        int n = snprintf(buf, sizeof(buf),
+                         "host%u.example.com - - [%02u/%s/1995:%02u:%02u:%02u -0400] \"GET /shuttle/missions/sts-%u/mission.html HTTP/1.0\" %d %u\n",
+                         r % 1000, 1 + r % 28, months[r % 3], r % 24, r % 60, (r >> 8) % 60, r % 5000, status, r % 10000);
+        text.append(buf, n);
+    }
+    return text;
+}
+
+template<class Parse>
+void run(const char *name, std::string_view text, long long lines, Parse parse) {
+    auto begin = std::chrono::steady_clock::now();
+    LineReader reader(text);
+    std::string_view line;
+    long long checksum = 0;
+    while (reader.next(line)) {
+        checksum += parse(line);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    printf("%-8s %8.2f ns/line %12.0f lines/sec %8.1f MB/sec (checksum %lld)\n", name, sec * 1e9 / lines,
+           lines / sec, text.size() / sec / 1e6, checksum);
+}
+
+int main(int argc, char *argv[]) {
+    long long lines = argc > 1 ? atoll(argv[1]) : 10000000;
+    std::string text = make_log(lines);
+    printf("%lld lines, %zu bytes\n", lines, text.size());
+
+    run("read", text, lines, [](std::string_view line) {
+        return line.size();
+    });
+    run("legacy", text, lines, [](std::string_view line) {
+        log cur = parse_log_legacy(line);
+        return cur.status + cur.request.size();
+    });
+    for (TokenizerKind kind: {TokenizerKind::Scalar, TokenizerKind::Sse2, TokenizerKind::Avx2}) {
+        if (kind > best_tokenizer()) {
+            continue;
+        }
+        run(tokenizer_name(kind), text, lines, [kind](std::string_view line) {
+            ClfFields f;
+            int status = 0;
+            if (!tokenize_clf(line, f, kind)) {
+                return 0ul;
+            }
+            std::from_chars(f.status.data(), f.status.data() + f.status.size(), status);
+            return status + f.request.size();
+        });
+    }
+    run("parse", text, lines, [](std::string_view line) {
+        log cur = parse_log(line);
+        return cur.status + cur.request.size();
+    });
+    return 0;
+}
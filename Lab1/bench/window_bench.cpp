@@ -0,0 +1,73 @@
+// Скорость поиска окна: прежний вектор с erase(begin()) против WindowSet на кольцевом буфере.
+// window_bench [seconds], по умолчанию 10M секунд с 1..20 запросами в каждой.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../lib/window.h"
+
+// окно, как его считал okno(): вектор времён, вытеснение из начала
+long long legacy_window(const std::vector<int> &times, int t) {
+    std::vector<int> window;
+    long long ans = 0;
+    for (int time: times) {
+        window.push_back(time);
+        while (window.back() - window.front() > t) {
+            window.erase(window.begin());
+        }
+        if (ans < (long long) window.size()) {
+            ans = window.size();
+        }
+    }
+    return ans;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main(int argc, char *argv[]) {
+    long long seconds = argc > 1 ? atoll(argv[1]) : 10000000;
+    std::vector<uint32_t> counts(seconds);
+    uint64_t seed = 239;
+    long long requests = 0;
+    for (uint32_t &c: counts) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        c = 1 + (seed >> 33) % 20;
+        requests += c;
+    }
+    const int base = 804556800;
+    printf("%lld seconds, %lld requests\n", seconds, requests);
+
+    std::vector<std::vector<int>> runs = {{60}, {3600}, {86400}, {60, 300, 3600, 86400}};
+    for (const std::vector<int> &lengths: runs) {
+        auto begin = std::chrono::steady_clock::now();
+        WindowSet okno(lengths);
+        for (long long i = 0; i < seconds; ++i) {
+            okno.add(base + i, counts[i]);
+        }
+        double sec = seconds_since(begin);
+        printf("ring   t=");
+        for (size_t i = 0; i < lengths.size(); ++i) {
+            printf(i ? ",%d" : "%d", lengths[i]);
+        }
+        printf("  %7.2f ns/second %12.0f seconds/sec (max %llu)\n", sec * 1e9 / seconds, seconds / sec,
+               (unsigned long long) okno.results()[0].count);
+    }
+
+    // прежний вариант квадратичен по длине окна, поэтому только на первых 2M запросов
+    std::vector<int> times;
+    for (long long i = 0; i < seconds && times.size() < 2000000; ++i) {
+        times.insert(times.end(), counts[i], base + i);
+    }
+    for (int t: {60, 600, 3600}) {
+        auto begin = std::chrono::steady_clock::now();
+        long long ans = legacy_window(times, t);
+        double sec = seconds_since(begin);
+        printf("legacy t=%d  %7.2f ns/request %12.0f requests/sec (max %lld)\n", t, sec * 1e9 / times.size(),
+               times.size() / sec, ans);
+    }
+    return 0;
+}
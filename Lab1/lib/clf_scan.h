@@ -0,0 +1,152 @@
+#pragma once
+// Общий движок tokenize_clf: классификатор отдаёт битовые маски структурных символов
+// блока (пробел, '[', ']', '"'), а автомат идёт только по выставленным битам.
+// Всё лежит в безымянном пространстве имён: parser.cpp и parser_avx2.cpp собираются
+// с разными флагами и не должны делить одни и те же инстанцирования.
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "parser.h"
+
+namespace {
+
+struct ClfMasks {
+    uint32_t space = 0;
+    uint32_t open = 0;
+    uint32_t close = 0;
+    uint32_t quote = 0;
+};
+
+enum ClfState {
+    kHost,
+    kOpen,
+    kClose,
+    kQuote,
+    kLastQuote,
+};
+
+inline uint32_t from_bit(int cursor) {
+    return cursor >= 32 ? 0 : ~0u << cursor;
+}
+
+struct ClfScan {
+    int state = kHost;
+    size_t pos[kLastQuote + 1] = {};
+
+    void block(const ClfMasks &m, size_t base) {
+        int cursor = 0;
+        while (true) {
+            uint32_t bits = from_bit(cursor);
+            switch (state) {
+                case kHost:
+                    bits &= m.space;
+                    break;
+                case kOpen:
+                    bits &= m.open;
+                    break;
+                case kClose:
+                    bits &= m.close;
+                    break;
+                case kQuote:
+                    bits &= m.quote;
+                    break;
+                default:
+                    // внутри запроса нужна только последняя кавычка строки
+                    bits &= m.quote;
+                    if (bits) {
+                        pos[kLastQuote] = base + 31 - std::countl_zero(bits);
+                    }
+                    return;
+            }
+            if (!bits) {
+                return;
+            }
+            int p = std::countr_zero(bits);
+            pos[state] = base + p;
+            cursor = p + 1;
+            if (state == kQuote) {
+                pos[kLastQuote] = base + p;
+            }
+            state++;
+        }
+    }
+};
+
+// по позициям структурных символов заполняет поля; статус - число сразу после последней кавычки
+inline bool finish_clf(std::string_view line, const size_t *pos, ClfFields &out) {
+    size_t q1 = pos[kQuote];
+    size_t q2 = pos[kLastQuote];
+    if (q2 == q1) {
+        return false;
+    }
+    size_t s = q2 + 1;
+    while (s < line.size() && line[s] == ' ') {
+        s++;
+    }
+    size_t e = s;
+    while (e < line.size() && line[e] >= '0' && line[e] <= '9') {
+        e++;
+    }
+    if (e == s) {
+        return false;
+    }
+    out.host = line.substr(0, pos[kHost]);
+    out.timestamp = line.substr(pos[kOpen] + 1, pos[kClose] - pos[kOpen] - 1);
+    out.request = line.substr(q1 + 1, q2 - q1 - 1);
+    out.status = line.substr(s, e - s);
+    return true;
+}
+
+// маски первых 32 байт строки
+template<int Width, class Classify>
+ClfMasks classify_head(const char *p, Classify classify) {
+    ClfMasks m = classify(p);
+    if constexpr (Width == 16) {
+        ClfMasks hi = classify(p + 16);
+        m.space |= hi.space << 16;
+        m.open |= hi.open << 16;
+        m.close |= hi.close << 16;
+        m.quote |= hi.quote << 16;
+    }
+    return m;
+}
+
+template<int Width, class Classify>
+bool scan_clf(std::string_view line, ClfFields &out, Classify classify) {
+    if (line.size() >= 64) {
+        // обычная строка: хост и '[' в первых 32 байтах, время фиксированной длины,
+        // последняя кавычка в последнем блоке - хватает пары загрузок
+        ClfMasks head = classify_head<Width>(line.data(), classify);
+        ClfMasks tail = classify(line.data() + line.size() - Width);
+        if (head.space && head.open && tail.quote) {
+            size_t pos[kLastQuote + 1];
+            pos[kHost] = std::countr_zero(head.space);
+            pos[kOpen] = std::countr_zero(head.open);
+            pos[kClose] = pos[kOpen] + 27;
+            pos[kQuote] = pos[kClose] + 2;
+            pos[kLastQuote] = line.size() - Width + 31 - std::countl_zero(tail.quote);
+            if (pos[kHost] < pos[kOpen] && pos[kQuote] < pos[kLastQuote] && line[pos[kClose]] == ']' &&
+                line[pos[kClose] + 1] == ' ' && line[pos[kQuote]] == '"' &&
+                memchr(line.data() + pos[kOpen], ']', 27) == nullptr) {
+                return finish_clf(line, pos, out);
+            }
+        }
+    }
+    ClfScan scan;
+    size_t i = 0;
+    for (; i + Width <= line.size(); i += Width) {
+        scan.block(classify(line.data() + i), i);
+    }
+    if (i < line.size()) {
+        // хвост копируется, чтобы не читать за концом отображённого файла; нули ничего не значат
+        char tail[Width] = {};
+        memcpy(tail, line.data() + i, line.size() - i);
+        scan.block(classify(tail), i);
+    }
+    return scan.state == kLastQuote && finish_clf(line, scan.pos, out);
+}
+
+}
@@ -0,0 +1,442 @@
+#include "gzip.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxBits = 15;
+constexpr int kFastBits = 10;
+constexpr size_t kWindow = 32768;
+constexpr size_t kFlush = 1 << 20;
+
+const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                6145, 8193, 12289, 16385, 24577};
+const uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+const uint8_t kCodeOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+struct Crc32 {
+    uint32_t table[256];
+
+    Crc32() {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+    }
+
+    uint32_t update(uint32_t crc, const char *data, size_t size) const {
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ uint8_t(data[i])) & 0xff] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+};
+
+const Crc32 crc32;
+
+// биты читаются младшими вперёд, до 64 бит про запас
+struct BitReader {
+    const uint8_t *data;
+    size_t size;
+    size_t pos = 0;
+    uint64_t bits = 0;
+    int count = 0;
+    bool overrun = false; // прочитано больше, чем было во входе
+
+    BitReader(std::string_view in) : data(reinterpret_cast<const uint8_t *>(in.data())), size(in.size()) {}
+
+    void refill() {
+        while (count <= 56) {
+            if (pos < size) {
+                bits |= uint64_t(data[pos++]) << count;
+            } else if (pos++ >= size + 8) {
+                overrun = true;
+                return;
+            }
+            count += 8;
+        }
+    }
+
+    uint32_t peek(int n) {
+        if (count < n) {
+            refill();
+        }
+        return bits & ((uint64_t(1) << n) - 1);
+    }
+
+    void drop(int n) {
+        bits >>= n;
+        count -= n;
+    }
+
+    uint32_t get(int n) {
+        uint32_t value = peek(n);
+        drop(n);
+        return value;
+    }
+
+    // к границе байта; байты, уже взятые в bits, возвращаются во вход
+    void align() {
+        drop(count % 8);
+        pos -= count / 8;
+        bits = 0;
+        count = 0;
+    }
+
+    // за концом входа читались нули
+    bool past_end() const {
+        return overrun || pos - count / 8 > size;
+    }
+};
+
+// канонический код Хаффмана: коды до kFastBits бит декодируются одной таблицей,
+// более длинные — по числу кодов каждой длины
+struct Huffman {
+    uint16_t fast[1 << kFastBits]; // (символ << 4) | длина, 0 — код длиннее kFastBits
+    uint16_t count[kMaxBits + 1];
+    uint16_t symbol[288];
+
+    bool build(const uint8_t *lengths, int n) {
+        memset(count, 0, sizeof(count));
+        for (int i = 0; i < n; ++i) {
+            count[lengths[i]]++;
+        }
+        count[0] = 0;
+        int left = 1;
+        for (int len = 1; len <= kMaxBits; ++len) {
+            left = (left << 1) - count[len];
+            if (left < 0) {
+                return false; // кодов больше, чем помещается
+            }
+        }
+        uint16_t offset[kMaxBits + 2];
+        uint16_t next[kMaxBits + 2];
+        offset[1] = 0;
+        next[1] = 0;
+        for (int len = 1; len <= kMaxBits; ++len) {
+            offset[len + 1] = offset[len] + count[len];
+            next[len + 1] = (next[len] + count[len]) << 1;
+        }
+        memset(fast, 0, sizeof(fast));
+        for (int i = 0; i < n; ++i) {
+            int len = lengths[i];
+            if (len == 0) {
+                continue;
+            }
+            symbol[offset[len]++] = i;
+            uint32_t code = next[len]++;
+            if (len > kFastBits) {
+                continue;
+            }
+            uint32_t reversed = 0;
+            for (int k = 0; k < len; ++k) {
+                reversed |= ((code >> k) & 1) << (len - 1 - k);
+            }
+            for (uint32_t fill = reversed; fill < (1u << kFastBits); fill += 1u << len) {
+                fast[fill] = uint16_t(i << 4 | len);
+            }
+        }
+        return true;
+    }
+
+    // -1, если такого кода нет
+    int decode(BitReader &in) const {
+        uint16_t entry = fast[in.peek(kFastBits)];
+        if (entry) {
+            in.drop(entry & 15);
+            return entry >> 4;
+        }
+        in.peek(kMaxBits);
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len <= kMaxBits; ++len) {
+            code |= in.get(1);
+            int n = count[len];
+            if (code - n < first) {
+                return symbol[index + (code - first)];
+            }
+            index += n;
+            first = (first + n) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+};
+
+class Inflater {
+public:
+    Inflater(const std::function<bool(std::string_view)> &sink) : sink(sink), out(kFlush + kWindow + 258) {}
+
+    bool stopped = false;
+    uint32_t crc = 0;
+    uint64_t total = 0;
+
+    // один поток DEFLATE; in стоит на его начале
+    bool inflate(BitReader &in, std::string &error) {
+        bool last = false;
+        while (!last && !stopped) {
+            last = in.get(1);
+            int type = in.get(2);
+            bool ok = type == 0 ? stored(in) : type == 1 ? fixed(in) : type == 2 ? dynamic(in) : false;
+            if (!ok || in.past_end()) {
+                error = type == 3 ? "bad block type" : "corrupt deflate stream";
+                return false;
+            }
+        }
+        return flush(0);
+    }
+
+    // отдаёт всё, кроме последних keep байт, которые ещё нужны как окно
+    bool flush(size_t keep) {
+        if (used > emitted) {
+            std::string_view ready(out.data() + emitted, used - emitted);
+            crc = crc32.update(crc, ready.data(), ready.size());
+            total += ready.size();
+            if (!stopped && !sink(ready)) {
+                stopped = true;
+            }
+            emitted = used;
+        }
+        if (used > keep) {
+            memmove(out.data(), out.data() + used - keep, keep);
+            used = emitted = keep;
+        }
+        return true;
+    }
+
+    void reset_window() {
+        used = emitted = 0;
+    }
+
+private:
+    const std::function<bool(std::string_view)> &sink;
+    std::vector<char> out;
+    size_t used = 0;    // байт в out, включая окно
+    size_t emitted = 0; // сколько из них уже отдано в sink
+
+    bool stored(BitReader &in) {
+        in.align();
+        if (in.pos + 4 > in.size) {
+            return false;
+        }
+        uint32_t len = in.data[in.pos] | in.data[in.pos + 1] << 8;
+        uint32_t nlen = in.data[in.pos + 2] | in.data[in.pos + 3] << 8;
+        in.pos += 4;
+        if ((len ^ 0xffff) != nlen || in.pos + len > in.size) {
+            return false;
+        }
+        while (len > 0) {
+            if (used >= kFlush + kWindow) {
+                flush(kWindow);
+            }
+            size_t n = std::min<size_t>(len, kFlush + kWindow - used);
+            memcpy(out.data() + used, in.data + in.pos, n);
+            used += n;
+            in.pos += n;
+            len -= n;
+        }
+        return true;
+    }
+
+    bool fixed(BitReader &in) {
+        static Huffman literals, distances;
+        static bool ready = [] {
+            uint8_t lengths[288];
+            memset(lengths, 8, 144);
+            memset(lengths + 144, 9, 112);
+            memset(lengths + 256, 7, 24);
+            memset(lengths + 280, 8, 8);
+            literals.build(lengths, 288);
+            memset(lengths, 5, 30);
+            distances.build(lengths, 30);
+            return true;
+        }();
+        (void) ready;
+        return codes(in, literals, distances);
+    }
+
+    bool dynamic(BitReader &in) {
+        int nlen = in.get(5) + 257;
+        int ndist = in.get(5) + 1;
+        int ncode = in.get(4) + 4;
+        if (nlen > 286 || ndist > 30) {
+            return false;
+        }
+        uint8_t lengths[320] = {};
+        for (int i = 0; i < ncode; ++i) {
+            lengths[kCodeOrder[i]] = in.get(3);
+        }
+        Huffman lencode;
+        if (!lencode.build(lengths, 19)) {
+            return false;
+        }
+        memset(lengths, 0, sizeof(lengths));
+        for (int i = 0; i < nlen + ndist;) {
+            int sym = lencode.decode(in);
+            if (sym < 0 || in.overrun) {
+                return false;
+            }
+            if (sym < 16) {
+                lengths[i++] = sym;
+                continue;
+            }
+            int repeat;
+            uint8_t value = 0;
+            if (sym == 16) {
+                if (i == 0) {
+                    return false;
+                }
+                value = lengths[i - 1];
+                repeat = 3 + in.get(2);
+            } else if (sym == 17) {
+                repeat = 3 + in.get(3);
+            } else {
+                repeat = 11 + in.get(7);
+            }
+            if (i + repeat > nlen + ndist) {
+                return false;
+            }
+            memset(lengths + i, value, repeat);
+            i += repeat;
+        }
+        if (lengths[256] == 0) {
+            return false; // нет кода конца блока
+        }
+        Huffman literals, distances;
+        return literals.build(lengths, nlen) && distances.build(lengths + nlen, ndist) &&
+               codes(in, literals, distances);
+    }
+
+    bool codes(BitReader &in, const Huffman &literals, const Huffman &distances) {
+        char *buf = out.data();
+        while (!in.overrun) {
+            if (used >= kFlush + kWindow) {
+                flush(kWindow);
+                if (stopped) {
+                    return true;
+                }
+            }
+            int sym = literals.decode(in);
+            if (sym < 256) {
+                if (sym < 0) {
+                    return false;
+                }
+                buf[used++] = char(sym);
+                continue;
+            }
+            if (sym == 256) {
+                return true;
+            }
+            sym -= 257;
+            if (sym >= 29) {
+                return false;
+            }
+            size_t len = kLengthBase[sym] + in.get(kLengthExtra[sym]);
+            int dsym = distances.decode(in);
+            if (dsym < 0 || dsym >= 30) {
+                return false;
+            }
+            size_t dist = kDistBase[dsym] + in.get(kDistExtra[dsym]);
+            if (dist > used) {
+                return false; // ссылка дальше начала данных
+            }
+            const char *from = buf + used - dist;
+            char *to = buf + used;
+            if (dist >= len) {
+                memcpy(to, from, len);
+            } else {
+                for (size_t k = 0; k < len; ++k) {
+                    to[k] = from[k];
+                }
+            }
+            used += len;
+        }
+        return false;
+    }
+};
+
+uint32_t read32(const uint8_t *p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | uint32_t(p[3]) << 24;
+}
+
+// пропускает заголовок gzip; false, если он повреждён
+bool skip_header(BitReader &in) {
+    const uint8_t *p = in.data;
+    size_t &pos = in.pos;
+    if (pos + 10 > in.size || p[pos] != 0x1f || p[pos + 1] != 0x8b || p[pos + 2] != 8) {
+        return false;
+    }
+    uint8_t flags = p[pos + 3];
+    pos += 10;
+    if (flags & 4) { // FEXTRA
+        if (pos + 2 > in.size) {
+            return false;
+        }
+        pos += 2 + (p[pos] | p[pos + 1] << 8);
+    }
+    for (int bit: {8, 16}) { // FNAME, FCOMMENT
+        if (flags & bit) {
+            while (pos < in.size && p[pos] != 0) {
+                pos++;
+            }
+            pos++;
+        }
+    }
+    if (flags & 2) { // FHCRC
+        pos += 2;
+    }
+    return pos <= in.size;
+}
+
+} // namespace
+
+bool is_gzip(std::string_view data) {
+    return data.size() >= 2 && uint8_t(data[0]) == 0x1f && uint8_t(data[1]) == 0x8b;
+}
+
+bool gunzip(std::string_view data, const std::function<bool(std::string_view)> &sink, std::string &error) {
+    Inflater inflater(sink);
+    BitReader in(data);
+    bool first = true;
+    while (first || (in.pos < in.size && is_gzip(data.substr(in.pos)))) {
+        first = false;
+        if (!skip_header(in)) {
+            error = "not a gzip file";
+            return false;
+        }
+        inflater.reset_window();
+        inflater.crc = 0;
+        inflater.total = 0;
+        if (!inflater.inflate(in, error)) {
+            return false;
+        }
+        if (inflater.stopped) {
+            return true;
+        }
+        in.align();
+        if (in.pos + 8 > in.size) {
+            error = "truncated gzip file";
+            return false;
+        }
+        if (read32(in.data + in.pos) != inflater.crc || read32(in.data + in.pos + 4) != uint32_t(inflater.total)) {
+            error = "gzip crc mismatch";
+            return false;
+        }
+        in.pos += 8;
+    }
+    return true;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Распаковка gzip (RFC 1952, сжатие DEFLATE из RFC 1951) без внешних библиотек.
+// Несколько склеенных gzip-потоков (как после cat a.gz b.gz) распаковываются подряд.
+
+// файл начинается с сигнатуры gzip
+bool is_gzip(std::string_view data);
+
+// распакованные данные отдаются в sink кусками по мере готовности (около 1 МБ);
+// если sink вернул false, распаковка останавливается без ошибки.
+// false и текст ошибки — повреждённый поток или несовпадение CRC32/длины.
+bool gunzip(std::string_view data, const std::function<bool(std::string_view)> &sink, std::string &error);
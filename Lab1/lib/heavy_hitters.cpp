@@ -0,0 +1,120 @@
+#include "heavy_hitters.h"
+
+#include <algorithm>
+#include <cmath>
+
+HeavyHitters::HeavyHitters(double epsilon) {
+    if (epsilon <= 0 || epsilon > 1) {
+        epsilon = 1e-4;
+    }
+    limit = std::max<size_t>(1, (size_t) std::ceil(1 / epsilon));
+}
+
+void HeavyHitters::swap_heap(size_t i, size_t j) {
+    std::swap(heap[i], heap[j]);
+    where[heap[i]] = i;
+    where[heap[j]] = j;
+}
+
+void HeavyHitters::sift_up(size_t i) {
+    while (i > 0 && items[heap[(i - 1) / 2]].count > items[heap[i]].count) {
+        swap_heap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+void HeavyHitters::sift_down(size_t i) {
+    while (true) {
+        size_t best = i;
+        for (size_t c = 2 * i + 1; c <= 2 * i + 2 && c < heap.size(); ++c) {
+            if (items[heap[c]].count < items[heap[best]].count) {
+                best = c;
+            }
+        }
+        if (best == i) {
+            return;
+        }
+        swap_heap(i, best);
+        i = best;
+    }
+}
+
+void HeavyHitters::add(std::string_view request) {
+    seen++;
+    auto it = index.find(request);
+    if (it != index.end()) {
+        items[it->second].count++;
+        sift_down(where[it->second]);
+        return;
+    }
+    if (items.size() < limit) {
+        items.push_back(Item{std::string(request), 1, 0});
+        heap.push_back(items.size() - 1);
+        where.push_back(heap.size() - 1);
+        index.emplace(items.back().request, items.size() - 1);
+        sift_up(heap.size() - 1);
+        return;
+    }
+    // вытесняется минимальный счётчик, новый запрос наследует его значение как ошибку
+    size_t victim = heap[0];
+    Item &item = items[victim];
+    index.erase(item.request);
+    item.error = item.count;
+    item.count++;
+    item.request.assign(request);
+    index.emplace(item.request, victim);
+    sift_down(0);
+}
+
+void HeavyHitters::rebuild() {
+    heap.resize(items.size());
+    where.resize(items.size());
+    index.clear();
+    for (size_t i = 0; i < items.size(); ++i) {
+        heap[i] = i;
+        where[i] = i;
+        index.emplace(items[i].request, i);
+    }
+    for (size_t i = heap.size() / 2; i-- > 0;) {
+        sift_down(i);
+    }
+}
+
+void HeavyHitters::merge(const HeavyHitters &other) {
+    // отсутствующий в сводке запрос мог встретиться не больше min_count() раз
+    uint64_t mine_min = min_count();
+    uint64_t other_min = other.min_count();
+    std::vector<Item> merged;
+    merged.reserve(items.size() + other.items.size());
+    for (const Item &item: items) {
+        auto it = other.index.find(item.request);
+        const Item *o = it == other.index.end() ? nullptr : &other.items[it->second];
+        merged.push_back(Item{item.request, item.count + (o ? o->count : other_min),
+                              item.error + (o ? o->error : other_min)});
+    }
+    for (const Item &o: other.items) {
+        if (index.find(o.request) == index.end()) {
+            merged.push_back(Item{o.request, o.count + mine_min, o.error + mine_min});
+        }
+    }
+    if (merged.size() > limit) {
+        std::nth_element(merged.begin(), merged.begin() + limit, merged.end(), [](const Item &a, const Item &b) {
+            return a.count != b.count ? a.count > b.count : a.request < b.request;
+        });
+        merged.resize(limit);
+    }
+    items.swap(merged);
+    seen += other.seen;
+    rebuild();
+}
+
+std::vector<HeavyHitters::Item> HeavyHitters::top(size_t k) const {
+    std::vector<Item> ans = items;
+    auto better = [](const Item &a, const Item &b) {
+        return a.count != b.count ? a.count > b.count : a.request < b.request;
+    };
+    k = std::min(k, ans.size());
+    std::partial_sort(ans.begin(), ans.begin() + k, ans.end(), better);
+    ans.resize(k);
+    return ans;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Space-Saving: не больше capacity счётчиков на весь поток. Оценка счётчика завышена
+// не больше чем на error этого счётчика, а error <= total / capacity.
+class HeavyHitters {
+public:
+    struct Item {
+        std::string request;
+        uint64_t count = 0;
+        uint64_t error = 0;
+    };
+
+    // epsilon - допустимая ошибка в долях от числа 5xx, счётчиков будет ceil(1 / epsilon)
+    explicit HeavyHitters(double epsilon = 1e-4);
+
+    void add(std::string_view request);
+
+    // слияние сводок (для потоков); оценки остаются завышенными, ошибки складываются
+    void merge(const HeavyHitters &other);
+
+    uint64_t total() const {
+        return seen;
+    }
+
+    size_t capacity() const {
+        return limit;
+    }
+
+    // гарантированная граница ошибки для любого запроса
+    uint64_t error_bound() const {
+        return min_count();
+    }
+
+    // k лучших по оценке, при равенстве по алфавиту
+    std::vector<Item> top(size_t k) const;
+
+private:
+    struct Hash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view s) const {
+            return std::hash<std::string_view>()(s);
+        }
+    };
+
+    uint64_t min_count() const {
+        return items.size() < limit ? 0 : items[heap[0]].count;
+    }
+
+    void sift_down(size_t i);
+    void sift_up(size_t i);
+    void swap_heap(size_t i, size_t j);
+    void rebuild();
+
+    size_t limit;
+    uint64_t seen = 0;
+    std::vector<Item> items;
+    std::vector<size_t> heap; // индексы items, минимум счётчика в heap[0]
+    std::vector<size_t> where; // позиция каждого item в heap
+    std::unordered_map<std::string, size_t, Hash, std::equal_to<>> index;
+};
@@ -0,0 +1,27 @@
+#include "histogram.h"
+
+void TimeHistogram::merge(const TimeHistogram &other) {
+    for (const auto &[key, block]: other.blocks) {
+        std::vector<uint32_t> &mine = blocks[key];
+        if (mine.empty()) {
+            mine = block;
+            continue;
+        }
+        for (size_t i = 0; i < block.size(); ++i) {
+            mine[i] += block[i];
+        }
+    }
+    last = nullptr;
+}
+
+std::vector<std::pair<int, uint32_t>> TimeHistogram::entries() const {
+    std::vector<std::pair<int, uint32_t>> ans;
+    for (const auto &[key, block]: blocks) {
+        for (size_t i = 0; i < block.size(); ++i) {
+            if (block[i] != 0) {
+                ans.emplace_back((key << kBlockBits) + (int) i, block[i]);
+            }
+        }
+    }
+    return ans;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Число запросов по секундам. Хранится блоками по 2^16 секунд, поэтому одиночная строка
+// с "чужим" временем не раздувает память. Гистограммы отдельных потоков складываются через merge().
+class TimeHistogram {
+public:
+    TimeHistogram() = default;
+    TimeHistogram(const TimeHistogram &) = delete;
+    TimeHistogram &operator=(const TimeHistogram &) = delete;
+    TimeHistogram(TimeHistogram &&) = default;
+    TimeHistogram &operator=(TimeHistogram &&) = default;
+
+    void add(int time, uint32_t count = 1) {
+        int key = time >> kBlockBits;
+        if (last == nullptr || key != last_key) {
+            std::vector<uint32_t> &block = blocks[key];
+            if (block.empty()) {
+                block.resize(1 << kBlockBits);
+            }
+            last = &block;
+            last_key = key;
+        }
+        (*last)[time & ((1 << kBlockBits) - 1)] += count;
+    }
+
+    void merge(const TimeHistogram &other);
+
+    // непустые секунды по возрастанию времени
+    std::vector<std::pair<int, uint32_t>> entries() const;
+
+private:
+    static const int kBlockBits = 16;
+    std::map<int, std::vector<uint32_t>> blocks;
+    std::vector<uint32_t> *last = nullptr;
+    int last_key = 0;
+};
@@ -0,0 +1,124 @@
+#include "load_profile.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// деление с округлением вниз и для отрицательного времени
+long long floor_div(long long a, long long b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+} // namespace
+
+LoadProfile::LoadProfile(const TimeHistogram &hist, int granularity) : step(std::max(1, granularity)) {
+    std::vector<std::pair<int, uint32_t>> seconds = hist.entries();
+    prefix.assign(1, 0);
+    if (seconds.empty()) {
+        return;
+    }
+    long long lo = floor_div(seconds.front().first, step);
+    long long hi = floor_div(seconds.back().first, step);
+    first = lo * step;
+    intervals = hi - lo + 1;
+    for (const auto &[time, count]: seconds) {
+        size_t i = floor_div(time, step) - lo;
+        if (index.empty() || index.back() != i) {
+            index.push_back(i);
+            prefix.push_back(prefix.back());
+        }
+        prefix.back() += count;
+    }
+}
+
+size_t LoadProfile::rank(size_t i) const {
+    return std::lower_bound(index.begin(), index.end(), i) - index.begin();
+}
+
+LoadProfile::Window LoadProfile::peak() const {
+    Window best;
+    for (size_t k = 0; k < index.size(); ++k) {
+        uint64_t count = prefix[k + 1] - prefix[k];
+        if (count > best.count) {
+            best = {first + (long long) index[k] * step, count};
+        }
+    }
+    return best;
+}
+
+uint64_t LoadProfile::percentile(double p) const {
+    if (size() == 0) {
+        return 0;
+    }
+    // nearest-rank: наименьшее значение, не меньше которого p% интервалов;
+    // пустые интервалы — нули в начале порядка, их не нужно хранить
+    size_t rank = (size_t) std::ceil(std::clamp(p, 0.0, 100.0) / 100 * size());
+    size_t k = rank == 0 ? 0 : rank - 1;
+    size_t zeros = size() - index.size();
+    if (k < zeros) {
+        return 0;
+    }
+    std::vector<uint64_t> counts(index.size());
+    for (size_t i = 0; i < index.size(); ++i) {
+        counts[i] = prefix[i + 1] - prefix[i];
+    }
+    std::nth_element(counts.begin(), counts.begin() + (k - zeros), counts.end());
+    return counts[k - zeros];
+}
+
+std::vector<LoadProfile::Window> LoadProfile::busiest(size_t length, size_t k) const {
+    std::vector<Window> result;
+    if (size() == 0 || length == 0 || k == 0) {
+        return result;
+    }
+    length = std::min(length, size());
+    size_t windows = size() - length + 1;
+    // сумма окна меняется только там, где в него входит или из него выходит непустой интервал,
+    // поэтому начала окон делятся на отрезки с постоянной суммой
+    std::vector<size_t> bounds = {0};
+    for (size_t i: index) {
+        if (i + 1 >= length) {
+            bounds.push_back(i + 1 - length);
+        }
+        bounds.push_back(i + 1);
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+    while (bounds.back() >= windows) {
+        bounds.pop_back();
+    }
+    bounds.push_back(windows);
+    std::vector<uint64_t> sums(bounds.size() - 1);
+    for (size_t s = 0; s + 1 < bounds.size(); ++s) {
+        sums[s] = sum(bounds[s], bounds[s] + length);
+    }
+
+    // как жадный проход по всем окнам по убыванию суммы (при равенстве раньше идёт более раннее):
+    // следующее взятое окно — лучшее из не пересекающихся с уже взятыми
+    std::vector<size_t> taken; // начала взятых окон по возрастанию
+    while (result.size() < k) {
+        Window best;
+        for (size_t s = 0; s < sums.size(); ++s) {
+            if (sums[s] <= best.count) {
+                continue;
+            }
+            // самое раннее начало в отрезке, не задевающее взятые окна
+            size_t i = bounds[s];
+            for (size_t t: taken) {
+                if (i + length > t && i < t + length) {
+                    i = t + length;
+                }
+            }
+            if (i < bounds[s + 1]) {
+                best = {(long long) i, sums[s]};
+            }
+        }
+        if (best.count == 0) {
+            break;
+        }
+        taken.insert(std::upper_bound(taken.begin(), taken.end(), (size_t) best.begin), best.begin);
+        result.push_back({first + best.begin * step, best.count});
+    }
+    return result;
+}
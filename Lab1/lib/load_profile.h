@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "histogram.h"
+
+// Профиль нагрузки: число запросов по интервалам в granularity секунд от первого интервала
+// с запросами до последнего (пустые внутри тоже считаются). Хранятся только непустые интервалы
+// и префиксные суммы по ним, как TimeHistogram хранит только занятые блоки, поэтому одна строка
+// с далёким временем не раздувает память. Сумма по окну — два бинарных поиска.
+class LoadProfile {
+public:
+    struct Window {
+        long long begin = 0; // unix time начала окна
+        uint64_t count = 0;
+    };
+
+    LoadProfile(const TimeHistogram &hist, int granularity);
+
+    int granularity() const {
+        return step;
+    }
+
+    // число интервалов от первого до последнего, включая пустые
+    size_t size() const {
+        return intervals;
+    }
+
+    // начало первого интервала, кратно granularity
+    long long start() const {
+        return first;
+    }
+
+    uint64_t at(size_t i) const {
+        return sum(i, i + 1);
+    }
+
+    // запросов в интервалах [i, j)
+    uint64_t sum(size_t i, size_t j) const {
+        return prefix[rank(j)] - prefix[rank(i)];
+    }
+
+    // самый нагруженный интервал
+    Window peak() const;
+
+    // p-й перцентиль (0..100) числа запросов на интервал, по рангу
+    uint64_t percentile(double p) const;
+
+    // k самых нагруженных непересекающихся окон из length интервалов, по убыванию
+    std::vector<Window> busiest(size_t length, size_t k) const;
+
+private:
+    // сколько непустых интервалов раньше i
+    size_t rank(size_t i) const;
+
+    int step;
+    long long first = 0;
+    size_t intervals = 0;
+    std::vector<size_t> index;    // номера непустых интервалов по возрастанию
+    std::vector<uint64_t> prefix; // prefix[k] — запросов в index[0..k)
+};
@@ -0,0 +1,338 @@
+#include "log_index.h"
+
+#include "parser.h"
+#include "time_index.h"
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[8] = {'A', 'L', 'O', 'G', 'I', 'D', 'X', '\0'};
+
+uint64_t align8(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+int64_t mtime_ns(const struct stat &st) {
+    return int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+bool write_at(int fd, const char *data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, offset);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+// буферизованная запись одной секции файла, начиная с заданного смещения
+class SectionWriter {
+public:
+    SectionWriter(int fd, uint64_t offset) : fd(fd), offset(offset), buffer(1 << 16) {}
+
+    void put(const void *data, size_t size) {
+        if (used + size > buffer.size()) {
+            flush();
+        }
+        if (size > buffer.size()) {
+            ok = ok && write_at(fd, static_cast<const char *>(data), size, offset);
+            offset += size;
+            return;
+        }
+        memcpy(buffer.data() + used, data, size);
+        used += size;
+    }
+
+    bool flush() {
+        ok = ok && write_at(fd, buffer.data(), used, offset);
+        offset += used;
+        used = 0;
+        return ok;
+    }
+
+private:
+    int fd;
+    uint64_t offset;
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool ok = true;
+};
+
+// строки получают номера в порядке первого появления
+struct Dictionary {
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::vector<std::string_view> names;
+    uint64_t bytes = 0;
+
+    uint32_t id(std::string_view name) {
+        auto [it, inserted] = ids.try_emplace(name, uint32_t(names.size()));
+        if (inserted) {
+            names.push_back(name);
+            bytes += name.size();
+        }
+        return it->second;
+    }
+
+    uint64_t section_size() const {
+        return align8((names.size() + 1) * sizeof(uint64_t) + bytes);
+    }
+
+    bool write(int fd, uint64_t offset) const {
+        SectionWriter out(fd, offset);
+        uint64_t begin = 0;
+        for (std::string_view name: names) {
+            out.put(&begin, sizeof(begin));
+            begin += name.size();
+        }
+        out.put(&begin, sizeof(begin));
+        for (std::string_view name: names) {
+            out.put(name.data(), name.size());
+        }
+        return out.flush();
+    }
+};
+
+} // namespace
+
+// 64-битная сумма по 8-байтным словам в четыре независимые цепочки
+uint64_t index_checksum(const char *data, size_t size) {
+    const uint64_t prime = 0x100000001b3ULL;
+    uint64_t h[4] = {0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL, 0x27d4eb2f165667c5ULL};
+    size_t words = size / 8;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            uint64_t w;
+            memcpy(&w, data + (i + k) * 8, 8);
+            h[k] = (h[k] ^ w) * prime;
+            h[k] ^= h[k] >> 29;
+        }
+    }
+    for (; i < words; ++i) {
+        uint64_t w;
+        memcpy(&w, data + i * 8, 8);
+        h[0] = (h[0] ^ w) * prime;
+        h[0] ^= h[0] >> 29;
+    }
+    uint64_t result = size;
+    for (int k = 0; k < 4; ++k) {
+        result = (result ^ h[k]) * prime;
+        result ^= result >> 31;
+    }
+    return result;
+}
+
+bool source_stamp(const char *log_path, uint64_t &size, int64_t &mtime) {
+    struct stat st;
+    if (stat(log_path, &st) != 0) {
+        return false;
+    }
+    size = st.st_size;
+    mtime = mtime_ns(st);
+    return true;
+}
+
+std::string index_path_for(const char *log_path) {
+    return std::string(log_path) + ".idx";
+}
+
+bool build_index(const char *log_path, const char *index_path, std::string &error, uint64_t *rows,
+                 TimeIndex *times) {
+    struct stat source;
+    if (stat(log_path, &source) != 0) {
+        error = "cannot stat log";
+        return false;
+    }
+    MappedFile in(log_path);
+    if (!in.is_open() || in.size() != uint64_t(source.st_size)) {
+        error = "cannot read log";
+        return false;
+    }
+    std::string_view text = in.view();
+
+    // место под столбцы берётся по числу строк, поэтому их можно писать сразу на свои места
+    uint64_t capacity = 0;
+    for (const char *p = text.data(), *end = p + text.size(); p < end; ++capacity) {
+        const char *nl = static_cast<const char *>(memchr(p, '\n', end - p));
+        p = nl ? nl + 1 : end;
+    }
+
+    LogIndexHeader header = {};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kLogIndexVersion;
+    header.header_size = align8(sizeof(LogIndexHeader));
+    header.source_size = source.st_size;
+    header.source_mtime = mtime_ns(source);
+    header.capacity = capacity;
+    header.time_offset = header.header_size;
+    header.status_offset = header.time_offset + align8(capacity * sizeof(int32_t));
+    header.request_offset = header.status_offset + align8(capacity * sizeof(uint16_t));
+    header.host_offset = header.request_offset + align8(capacity * sizeof(uint32_t));
+    header.request_dict_offset = header.host_offset + align8(capacity * sizeof(uint32_t));
+
+    // пишем во временный файл и подменяем им индекс в конце, чтобы читатель не увидел половину
+    std::string tmp_path = std::string(index_path) + ".tmp";
+    int fd = open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (fd < 0) {
+        error = "cannot create " + tmp_path;
+        return false;
+    }
+
+    Dictionary requests;
+    Dictionary hosts;
+    SectionWriter time_column(fd, header.time_offset);
+    SectionWriter status_column(fd, header.status_offset);
+    SectionWriter request_column(fd, header.request_offset);
+    SectionWriter host_column(fd, header.host_offset);
+    LineReader reader(text);
+    std::string_view line;
+    while (reader.next(line)) {
+        log cur = parse_log(line);
+        if (cur.status == -9) {
+            continue;
+        }
+        if (times) {
+            times->add(line.data() - text.data(), cur.time);
+        }
+        int32_t time = cur.time;
+        uint16_t status = cur.status < 0 || cur.status > 0xffff ? 0xffff : cur.status;
+        uint32_t request = requests.id(cur.request);
+        uint32_t host = hosts.id(cur.anlog);
+        time_column.put(&time, sizeof(time));
+        status_column.put(&status, sizeof(status));
+        request_column.put(&request, sizeof(request));
+        host_column.put(&host, sizeof(host));
+        header.rows++;
+    }
+    bool ok = time_column.flush() && status_column.flush() && request_column.flush() && host_column.flush();
+
+    header.request_count = requests.names.size();
+    header.host_count = hosts.names.size();
+    header.host_dict_offset = header.request_dict_offset + requests.section_size();
+    header.file_size = header.host_dict_offset + hosts.section_size();
+    ok = ok && requests.write(fd, header.request_dict_offset) && hosts.write(fd, header.host_dict_offset);
+    // дыры (хвосты столбцов и выравнивание) читаются нулями
+    ok = ok && ftruncate(fd, header.file_size) == 0;
+    close(fd);
+    if (!ok) {
+        error = "cannot write " + tmp_path;
+        unlink(tmp_path.c_str());
+        return false;
+    }
+
+    {
+        MappedFile written(tmp_path.c_str());
+        if (!written.is_open() || written.size() != header.file_size) {
+            error = "cannot read back " + tmp_path;
+            unlink(tmp_path.c_str());
+            return false;
+        }
+        std::string_view body = written.view().substr(header.header_size);
+        header.checksum = index_checksum(body.data(), body.size());
+    }
+    fd = open(tmp_path.c_str(), O_WRONLY);
+    ok = fd >= 0 && write_at(fd, reinterpret_cast<const char *>(&header), sizeof(header), 0);
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (!ok || rename(tmp_path.c_str(), index_path) != 0) {
+        error = "cannot write " + std::string(index_path);
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    if (rows) {
+        *rows = header.rows;
+    }
+    return true;
+}
+
+LogIndex::LogIndex(const char *index_path) : file(index_path) {
+    if (!file.is_open() || file.size() < sizeof(LogIndexHeader)) {
+        return;
+    }
+    const LogIndexHeader *h = reinterpret_cast<const LogIndexHeader *>(file.view().data());
+    if (memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->header_size != align8(sizeof(LogIndexHeader))) {
+        return;
+    }
+    header = h;
+}
+
+bool LogIndex::fresh_for(const char *log_path, std::string &reason) const {
+    if (!header) {
+        reason = "not an index";
+        return false;
+    }
+    if (header->version != kLogIndexVersion) {
+        reason = "version " + std::to_string(header->version) + ", expected " + std::to_string(kLogIndexVersion);
+        return false;
+    }
+    uint64_t cap = header->capacity;
+    if (header->file_size != file.size() || header->rows > cap ||
+        header->time_offset != header->header_size ||
+        header->status_offset != header->time_offset + align8(cap * sizeof(int32_t)) ||
+        header->request_offset != header->status_offset + align8(cap * sizeof(uint16_t)) ||
+        header->host_offset != header->request_offset + align8(cap * sizeof(uint32_t)) ||
+        header->request_dict_offset != header->host_offset + align8(cap * sizeof(uint32_t)) ||
+        header->request_dict_offset + (header->request_count + 1) * sizeof(uint64_t) > header->host_dict_offset ||
+        header->host_dict_offset + (header->host_count + 1) * sizeof(uint64_t) > header->file_size) {
+        reason = "damaged layout";
+        return false;
+    }
+    struct stat source;
+    if (stat(log_path, &source) != 0) {
+        reason = "log is missing";
+        return false;
+    }
+    if (header->source_size != uint64_t(source.st_size) || header->source_mtime != mtime_ns(source)) {
+        reason = "log changed after indexing";
+        return false;
+    }
+    std::string_view body = file.view().substr(header->header_size);
+    if (index_checksum(body.data(), body.size()) != header->checksum) {
+        reason = "checksum mismatch";
+        return false;
+    }
+    return true;
+}
+
+const int32_t *LogIndex::times() const {
+    return reinterpret_cast<const int32_t *>(file.view().data() + header->time_offset);
+}
+
+const uint16_t *LogIndex::statuses() const {
+    return reinterpret_cast<const uint16_t *>(file.view().data() + header->status_offset);
+}
+
+const uint32_t *LogIndex::requests() const {
+    return reinterpret_cast<const uint32_t *>(file.view().data() + header->request_offset);
+}
+
+const uint32_t *LogIndex::hosts() const {
+    return reinterpret_cast<const uint32_t *>(file.view().data() + header->host_offset);
+}
+
+std::string_view LogIndex::dict_entry(uint64_t offset, uint64_t count, uint32_t id) const {
+    const char *base = file.view().data() + offset;
+    const uint64_t *begin = reinterpret_cast<const uint64_t *>(base);
+    const char *bytes = base + (count + 1) * sizeof(uint64_t);
+    return std::string_view(bytes + begin[id], begin[id + 1] - begin[id]);
+}
+
+std::string_view LogIndex::request(uint32_t id) const {
+    return dict_entry(header->request_dict_offset, header->request_count, id);
+}
+
+std::string_view LogIndex::host(uint32_t id) const {
+    return dict_entry(header->host_dict_offset, header->host_count, id);
+}
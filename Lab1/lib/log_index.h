@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "mapped_file.h"
+
+// Колоночный кэш разобранного лога (файл <лог>.idx). Одна строка лога — одна запись:
+// время, статус, номер запроса и номер хоста в словарях. Строки, которые не разобрались,
+// в индекс не попадают.
+//
+// Раскладка файла (все числа в порядке байт машины, секции выровнены на 8 байт):
+//   LogIndexHeader
+//   int32_t  time[rows]
+//   uint16_t status[rows]
+//   uint32_t request[rows]
+//   uint32_t host[rows]
+//   словарь запросов: uint64_t begin[count + 1], затем сами строки подряд
+//   словарь хостов: так же
+struct LogIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t source_size;   // размер и время изменения лога, по которому построен индекс
+    int64_t source_mtime;   // в наносекундах
+    uint64_t rows;
+    uint64_t capacity;      // место под столбцы (число строк лога), rows <= capacity
+    uint64_t request_count;
+    uint64_t host_count;
+    uint64_t time_offset;
+    uint64_t status_offset;
+    uint64_t request_offset;
+    uint64_t host_offset;
+    uint64_t request_dict_offset;
+    uint64_t host_dict_offset;
+    uint64_t file_size;
+    uint64_t checksum;      // по всему, что после заголовка
+};
+
+constexpr uint32_t kLogIndexVersion = 1;
+
+class TimeIndex;
+
+// размер и время изменения лога (в наносекундах), по ним узнаются устаревшие индексы
+bool source_stamp(const char *log_path, uint64_t &size, int64_t &mtime);
+
+// контрольная сумма файлов индекса, size кратен 8
+uint64_t index_checksum(const char *data, size_t size);
+
+// путь индекса по умолчанию: <лог>.idx
+std::string index_path_for(const char *log_path);
+
+// строит индекс за один проход по логу; false и текст ошибки, если не вышло.
+// Если передан times, в том же проходе заполняется и разреженный индекс времени.
+bool build_index(const char *log_path, const char *index_path, std::string &error, uint64_t *rows = nullptr,
+                 TimeIndex *times = nullptr);
+
+class LogIndex {
+public:
+    explicit LogIndex(const char *index_path);
+
+    // индекс цел (версия, размеры, контрольная сумма) и построен по текущему состоянию лога
+    bool fresh_for(const char *log_path, std::string &reason) const;
+
+    bool is_open() const {
+        return header != nullptr;
+    }
+
+    uint64_t rows() const {
+        return header->rows;
+    }
+
+    const int32_t *times() const;
+    const uint16_t *statuses() const;
+    const uint32_t *requests() const;
+    const uint32_t *hosts() const;
+
+    size_t request_count() const {
+        return header->request_count;
+    }
+
+    size_t host_count() const {
+        return header->host_count;
+    }
+
+    std::string_view request(uint32_t id) const;
+    std::string_view host(uint32_t id) const;
+
+private:
+    std::string_view dict_entry(uint64_t offset, uint64_t count, uint32_t id) const;
+
+    MappedFile file;
+    const LogIndexHeader *header = nullptr;
+};
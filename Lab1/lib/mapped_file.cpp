@@ -0,0 +1,39 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return;
+    }
+    length = st.st_size;
+    if (length == 0) { // пустой файл отобразить нельзя, но читать его можно
+        opened = true;
+        close(fd);
+        return;
+    }
+    void *ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        length = 0;
+        return;
+    }
+    madvise(ptr, length, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(ptr);
+    opened = true;
+}
+
+MappedFile::~MappedFile() {
+    if (data) {
+        munmap(const_cast<char *>(data), length);
+    }
+}
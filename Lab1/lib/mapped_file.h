@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+// Файл, отображённый в память только на чтение. Строки отдаются как string_view
+// прямо в отображение, без копирования и аллокаций.
+class MappedFile {
+public:
+    explicit MappedFile(const char *path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool is_open() const {
+        return opened;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    std::string_view view() const {
+        return std::string_view(data, length);
+    }
+
+private:
+    const char *data = nullptr;
+    size_t length = 0;
+    bool opened = false;
+};
+
+// Построчный обход куска памяти; '\n' и '\r' в строку не попадают.
+class LineReader {
+public:
+    explicit LineReader(std::string_view text) : rest(text) {}
+
+    bool next(std::string_view &line) {
+        if (rest.empty()) {
+            return false;
+        }
+        const char *begin = rest.data();
+        const char *end = static_cast<const char *>(memchr(begin, '\n', rest.size()));
+        size_t len = end ? end - begin : rest.size();
+        rest.remove_prefix(end ? len + 1 : len);
+        if (len > 0 && begin[len - 1] == '\r') {
+            len--;
+        }
+        line = std::string_view(begin, len);
+        return true;
+    }
+
+private:
+    std::string_view rest;
+};
@@ -0,0 +1,102 @@
+#include "output_writer.h"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+OutputWriter::OutputWriter() : buffer(kBufferSize) {}
+
+OutputWriter::~OutputWriter() {
+    flush();
+    for (const Sink &sink: sinks) {
+        if (sink.own) {
+            close(sink.fd);
+        }
+    }
+}
+
+bool OutputWriter::open_file(const char *path) {
+    int fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (fd < 0) {
+        fail(errno);
+        return false;
+    }
+    sinks.push_back({fd, true});
+    return true;
+}
+
+void OutputWriter::add_fd(int fd) {
+    sinks.push_back({fd, false});
+}
+
+void OutputWriter::add_block(std::string_view text) {
+    if (used + text.size() <= buffer.size()) {
+        memcpy(buffer.data() + used, text.data(), text.size());
+        used += text.size();
+        return;
+    }
+    write_all(std::string_view(buffer.data(), used), text);
+    used = 0;
+}
+
+void OutputWriter::spill(std::string_view line) {
+    if (line.size() + 1 <= buffer.size()) {
+        flush();
+        memcpy(buffer.data(), line.data(), line.size());
+        used = line.size();
+        return;
+    }
+    write_all(std::string_view(buffer.data(), used), line);
+    used = 0;
+}
+
+bool OutputWriter::flush() {
+    if (used > 0) {
+        write_all(std::string_view(buffer.data(), used), {});
+        used = 0;
+    }
+    return !failed;
+}
+
+void OutputWriter::fail(int code) {
+    if (!failed) {
+        error_code = code;
+    }
+    failed = true;
+}
+
+// оба куска подряд в каждый приёмник, с дозаписью при частичном writev
+void OutputWriter::write_all(std::string_view first, std::string_view second) {
+    for (const Sink &sink: sinks) {
+        iovec parts[2] = {{const_cast<char *>(first.data()), first.size()},
+                          {const_cast<char *>(second.data()), second.size()}};
+        iovec *iov = parts;
+        int count = 2;
+        while (count > 0) {
+            if (iov->iov_len == 0) {
+                iov++;
+                count--;
+                continue;
+            }
+            ssize_t n = writev(sink.fd, iov, count);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                fail(n < 0 ? errno : EIO);
+                break;
+            }
+            while (count > 0 && size_t(n) >= iov->iov_len) {
+                n -= iov->iov_len;
+                iov++;
+                count--;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char *>(iov->iov_base) + n;
+                iov->iov_len -= n;
+            }
+        }
+    }
+}
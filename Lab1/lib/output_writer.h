@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Вывод строк сразу в несколько приёмников (файл -o и stdout при -p) через один большой буфер.
+// Буфер уходит одним writev на приёмник, когда заполнится, и при flush(); большие готовые
+// куски (add_block) не копируются, а идут в тот же writev вторым элементом.
+class OutputWriter {
+public:
+    static constexpr size_t kBufferSize = 1 << 20;
+
+    OutputWriter();
+    ~OutputWriter(); // flush() и закрытие своих файлов
+
+    OutputWriter(const OutputWriter &) = delete;
+    OutputWriter &operator=(const OutputWriter &) = delete;
+
+    // файл создаётся (или обрезается) и закрывается в деструкторе
+    bool open_file(const char *path);
+    // чужой дескриптор, например STDOUT_FILENO; не закрывается
+    void add_fd(int fd);
+
+    bool active() const {
+        return !sinks.empty();
+    }
+
+    // строка без '\n', он дописывается
+    void add(std::string_view line) {
+        if (used + line.size() + 1 > buffer.size()) {
+            spill(line);
+        } else {
+            memcpy(buffer.data() + used, line.data(), line.size());
+            used += line.size();
+        }
+        buffer[used++] = '\n';
+    }
+
+    // уже готовый кусок строк, каждая со своим '\n'
+    void add_block(std::string_view text);
+
+    // false, если какая-то запись не удалась (с этого момента или раньше)
+    bool flush();
+
+    bool ok() const {
+        return !failed;
+    }
+
+    // errno первой неудачи, 0 если всё записано
+    int error() const {
+        return error_code;
+    }
+
+private:
+    struct Sink {
+        int fd;
+        bool own;
+    };
+
+    // строка не влезла: буфер сбрасывается, длинная строка пишется сразу
+    void spill(std::string_view line);
+    void write_all(std::string_view first, std::string_view second);
+    void fail(int code);
+
+    std::vector<Sink> sinks;
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool failed = false;
+    int error_code = 0;
+};
@@ -0,0 +1,173 @@
+#include "parser.h"
+
+#include "clf_scan.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ANALYZELOG_SSE2
+#endif
+
+#ifdef ANALYZELOG_AVX2
+bool tokenize_clf_avx2(std::string_view line, ClfFields &out);
+#endif
+
+namespace {
+
+// без SIMD: те же позиции ищутся memchr, последняя кавычка - проходом с конца
+bool scan_clf_scalar(std::string_view line, ClfFields &out) {
+    size_t pos[kLastQuote + 1];
+    const char *begin = line.data();
+    const char *end = begin + line.size();
+    const char *p = begin;
+    const char wanted[kLastQuote] = {' ', '[', ']', '"'};
+    for (int state = kHost; state < kLastQuote; ++state) {
+        p = static_cast<const char *>(memchr(p, wanted[state], end - p));
+        if (p == nullptr) {
+            return false;
+        }
+        pos[state] = p - begin;
+        p++;
+    }
+    const char *last = end - 1;
+    while (*last != '"') {
+        last--;
+    }
+    pos[kLastQuote] = last - begin;
+    return finish_clf(line, pos, out);
+}
+
+#ifdef ANALYZELOG_SSE2
+ClfMasks classify_sse2(const char *p) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    ClfMasks m;
+    m.space = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    m.open = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('[')));
+    m.close = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(']')));
+    m.quote = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+    return m;
+}
+#endif
+
+bool digits(std::string_view s, size_t pos, size_t n, int &value) {
+    value = 0;
+    for (size_t i = pos; i < pos + n; ++i) {
+        if (s[i] < '0' || s[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (s[i] - '0');
+    }
+    return true;
+}
+
+int month_index(std::string_view m) {
+    static const char names[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    for (int i = 0; i < 12; ++i) {
+        if (m[0] == names[3 * i] && m[1] == names[3 * i + 1] && m[2] == names[3 * i + 2]) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// число дней от 1970-01-01 (алгоритм days_from_civil)
+long long days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+}
+
+TokenizerKind best_tokenizer() {
+#ifdef ANALYZELOG_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return TokenizerKind::Avx2;
+    }
+#endif
+#ifdef ANALYZELOG_SSE2
+    return TokenizerKind::Sse2;
+#else
+    return TokenizerKind::Scalar;
+#endif
+}
+
+const char *tokenizer_name(TokenizerKind kind) {
+    switch (kind) {
+        case TokenizerKind::Avx2:
+            return "avx2";
+        case TokenizerKind::Sse2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+bool tokenize_clf(std::string_view line, ClfFields &out, TokenizerKind kind) {
+    switch (kind) {
+#ifdef ANALYZELOG_AVX2
+        case TokenizerKind::Avx2:
+            return tokenize_clf_avx2(line, out);
+#endif
+#ifdef ANALYZELOG_SSE2
+        case TokenizerKind::Sse2:
+            return scan_clf<16>(line, out, [](const char *p) { return classify_sse2(p); });
+#endif
+        default:
+            return scan_clf_scalar(line, out);
+    }
+}
+
+bool tokenize_clf(std::string_view line, ClfFields &out) {
+    static const TokenizerKind kind = best_tokenizer();
+    return tokenize_clf(line, out, kind);
+}
+
+bool parse_clf_time(std::string_view ts, int &time) {
+    // 03/Jul/1995:10:50:02 -0400
+    if (ts.size() < 20 || ts[2] != '/' || ts[6] != '/' || ts[11] != ':' || ts[14] != ':' || ts[17] != ':') {
+        return false;
+    }
+    // дата почти всегда та же, что в прошлой строке, её разбор кэшируется на поток
+    thread_local char last_date[11] = {};
+    thread_local long long last_days = 0;
+    if (memcmp(last_date, ts.data(), 11) != 0) {
+        int d, m, y;
+        m = month_index(ts.substr(3, 3));
+        if (m == 0 || !digits(ts, 0, 2, d) || !digits(ts, 7, 4, y)) {
+            return false;
+        }
+        last_days = days_from_civil(y, m, d);
+        memcpy(last_date, ts.data(), 11);
+    }
+    int h, mi, s;
+    if (!digits(ts, 12, 2, h) || !digits(ts, 15, 2, mi) || !digits(ts, 18, 2, s)) {
+        return false;
+    }
+    long long ans = last_days * 86400 + h * 3600 + mi * 60 + s;
+    if (ts.size() >= 26 && ts[20] == ' ' && (ts[21] == '+' || ts[21] == '-')) {
+        int zh, zm;
+        if (!digits(ts, 22, 2, zh) || !digits(ts, 24, 2, zm)) {
+            return false;
+        }
+        int offset = zh * 3600 + zm * 60;
+        ans += ts[21] == '+' ? -offset : offset;
+    }
+    time = ans;
+    return true;
+}
+
+log parse_log(std::string_view line) {
+    log ans;
+    ClfFields f;
+    if (!tokenize_clf(line, f) || !parse_clf_time(f.timestamp, ans.time) ||
+        std::from_chars(f.status.data(), f.status.data() + f.status.size(), ans.status).ec != std::errc()) {
+        ans.status = -9;
+        return ans;
+    }
+    ans.request = f.request;
+    ans.anlog = f.host;
+    return ans;
+}
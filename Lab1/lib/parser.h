@@ -0,0 +1,39 @@
+#pragma once
+#include <string_view>
+
+struct log {
+    int status = 0;
+    std::string_view request = "";
+    int time = 0; // unix time, UTC
+    std::string_view anlog = ""; // указывают прямо в исходную строку
+};
+
+// поля строки Common Log Format: <host> - - [<time>] "<request>" <status> <bytes>
+// все поля указывают внутрь исходной строки
+struct ClfFields {
+    std::string_view host;
+    std::string_view timestamp; // без скобок: 03/Jul/1995:10:50:02 -0400
+    std::string_view request;   // без кавычек
+    std::string_view status;
+};
+
+enum class TokenizerKind {
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+// лучший вариант, доступный на этом процессоре
+TokenizerKind best_tokenizer();
+
+const char *tokenizer_name(TokenizerKind kind);
+
+// один проход по строке; false, если строка не в формате CLF
+bool tokenize_clf(std::string_view line, ClfFields &out);
+bool tokenize_clf(std::string_view line, ClfFields &out, TokenizerKind kind);
+
+// "dd/Mon/yyyy:hh:mm:ss [+-]zzzz" -> unix time
+bool parse_clf_time(std::string_view ts, int &time);
+
+// status == -9, если строку разобрать не удалось
+log parse_log(std::string_view line);
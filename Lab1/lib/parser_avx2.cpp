@@ -0,0 +1,22 @@
+// собирается с -mavx2, вызывается только если процессор поддерживает AVX2
+#include <immintrin.h>
+
+#include "clf_scan.h"
+
+namespace {
+
+ClfMasks classify_avx2(const char *p) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    ClfMasks m;
+    m.space = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+    m.open = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('[')));
+    m.close = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(']')));
+    m.quote = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+    return m;
+}
+
+}
+
+bool tokenize_clf_avx2(std::string_view line, ClfFields &out) {
+    return scan_clf<32>(line, out, [](const char *p) { return classify_avx2(p); });
+}
@@ -0,0 +1,130 @@
+#include "request_counter.h"
+
+#include <algorithm>
+#include <functional>
+
+void RequestCounter::add(std::string_view request, uint64_t count) {
+    add(request, std::hash<std::string_view>()(request), count);
+}
+
+void RequestCounter::add(std::string_view request, uint64_t hash, uint64_t count) {
+    if ((used + 1) * 4 > slots.size() * 3) {
+        grow();
+    }
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Slot &slot = slots[i];
+        if (slot.count == 0) {
+            slot.hash = hash;
+            slot.offset = pool.size();
+            slot.length = request.size();
+            slot.count = count;
+            pool.append(request);
+            used++;
+            return;
+        }
+        if (slot.hash == hash && key(slot) == request) {
+            slot.count += count;
+            return;
+        }
+    }
+}
+
+void RequestCounter::grow() {
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.resize(old.empty() ? 1024 : old.size() * 2);
+    size_t mask = slots.size() - 1;
+    for (const Slot &slot: old) {
+        if (slot.count == 0) {
+            continue;
+        }
+        size_t i = slot.hash & mask;
+        while (slots[i].count != 0) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = slot;
+    }
+}
+
+void RequestCounter::merge(const RequestCounter &other) {
+    for (const Slot &slot: other.slots) {
+        if (slot.count != 0) {
+            add(other.key(slot), slot.hash, slot.count);
+        }
+    }
+}
+
+namespace {
+
+using Entry = std::pair<std::string_view, uint64_t>;
+
+// "лучше" - больше счётчик, при равенстве меньше строка; на вершине кучи худший из k
+bool better(const Entry &a, const Entry &b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+}
+
+void keep_best(std::vector<Entry> &heap, size_t k, const Entry &cur) {
+    if (heap.size() < k) {
+        heap.push_back(cur);
+        std::push_heap(heap.begin(), heap.end(), better);
+    } else if (better(cur, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), better);
+        heap.back() = cur;
+        std::push_heap(heap.begin(), heap.end(), better);
+    }
+}
+
+} // namespace
+
+const RequestCounter::Slot *RequestCounter::find(std::string_view request, uint64_t hash) const {
+    if (slots.empty()) {
+        return nullptr;
+    }
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask; slots[i].count != 0; i = (i + 1) & mask) {
+        if (slots[i].hash == hash && key(slots[i]) == request) {
+            return &slots[i];
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::pair<std::string_view, uint64_t>> RequestCounter::top(size_t k) const {
+    std::vector<Entry> heap;
+    if (k == 0) {
+        return heap;
+    }
+    heap.reserve(std::min(k, used));
+    for (const Slot &slot: slots) {
+        if (slot.count != 0) {
+            keep_best(heap, k, Entry(key(slot), slot.count));
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), better);
+    return heap;
+}
+
+std::vector<std::pair<std::string_view, uint64_t>> RequestCounter::top(size_t k, const std::vector<std::string> &previous,
+                                                                       const RequestCounter &fresh) const {
+    std::vector<Entry> heap;
+    if (k == 0) {
+        return heap;
+    }
+    for (const Slot &slot: fresh.slots) {
+        const Slot *mine = slot.count != 0 ? find(fresh.key(slot), slot.hash) : nullptr;
+        if (mine) {
+            keep_best(heap, k, Entry(key(*mine), mine->count));
+        }
+    }
+    for (const std::string &request: previous) {
+        uint64_t hash = std::hash<std::string_view>()(request);
+        const Slot *mine = find(request, hash);
+        // запросы из fresh уже учтены
+        if (mine && !fresh.find(request, hash)) {
+            keep_best(heap, k, Entry(key(*mine), mine->count));
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), better);
+    return heap;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Точный счётчик запросов: открытая адресация (линейное пробирование), строки запросов
+// хранятся один раз в общем буфере. Память растёт с числом различных запросов.
+class RequestCounter {
+public:
+    void add(std::string_view request, uint64_t count = 1);
+
+    void merge(const RequestCounter &other);
+
+    size_t size() const {
+        return used;
+    }
+
+    // k самых частых за O(U log k): по убыванию счётчика, при равенстве по возрастанию запроса.
+    // Строки указывают в буфер счётчика и живут до следующего add().
+    std::vector<std::pair<std::string_view, uint64_t>> top(size_t k) const;
+
+    // то же, если с прошлого top(k) (previous) в счётчик добавились только запросы из fresh:
+    // счётчики только растут, поэтому новые k лучших — среди previous и fresh, O((k + |fresh|) log k)
+    std::vector<std::pair<std::string_view, uint64_t>> top(size_t k, const std::vector<std::string> &previous,
+                                                            const RequestCounter &fresh) const;
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        uint64_t offset = 0;
+        uint32_t length = 0;
+        uint64_t count = 0; // 0 - слот свободен
+    };
+
+    std::string_view key(const Slot &slot) const {
+        return std::string_view(pool.data() + slot.offset, slot.length);
+    }
+
+    void add(std::string_view request, uint64_t hash, uint64_t count);
+    const Slot *find(std::string_view request, uint64_t hash) const;
+    void grow();
+
+    std::vector<Slot> slots;
+    std::string pool;
+    size_t used = 0;
+};
@@ -0,0 +1,174 @@
+#include "time_index.h"
+
+#include "log_index.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[8] = {'A', 'L', 'O', 'G', 'T', 'I', 'X', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct TimeIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t step;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t blocks;
+    uint64_t checksum; // по lo и hi
+};
+
+// начало первой строки, которая начинается не раньше offset
+size_t line_start(std::string_view text, size_t offset) {
+    if (offset == 0 || offset >= text.size()) {
+        return std::min(offset, text.size());
+    }
+    if (text[offset - 1] == '\n') {
+        return offset;
+    }
+    size_t nl = text.find('\n', offset);
+    return nl == std::string_view::npos ? text.size() : nl + 1;
+}
+
+} // namespace
+
+TimeIndex::TimeIndex(uint32_t step) : step(step) {}
+
+void TimeIndex::add(uint64_t offset, int time) {
+    size_t block = offset / step;
+    if (block >= lo.size()) {
+        lo.resize(block + 1, INT_MAX);
+        hi.resize(block + 1, INT_MIN);
+    }
+    lo[block] = std::min(lo[block], time);
+    hi[block] = std::max(hi[block], time);
+}
+
+void TimeIndex::merge(const TimeIndex &other) {
+    if (other.lo.size() > lo.size()) {
+        lo.resize(other.lo.size(), INT_MAX);
+        hi.resize(other.hi.size(), INT_MIN);
+    }
+    for (size_t k = 0; k < other.lo.size(); ++k) {
+        lo[k] = std::min(lo[k], other.lo[k]);
+        hi[k] = std::max(hi[k], other.hi[k]);
+    }
+}
+
+void TimeIndex::prepare() {
+    size_t n = lo.size();
+    prefix_hi.resize(n);
+    suffix_lo.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        prefix_hi[k] = std::max(hi[k], k ? prefix_hi[k - 1] : INT_MIN);
+    }
+    for (size_t k = n; k-- > 0;) {
+        suffix_lo[k] = std::min(lo[k], k + 1 < n ? suffix_lo[k + 1] : INT_MAX);
+    }
+}
+
+std::vector<std::string_view> TimeIndex::ranges(std::string_view text, long long from, long long to) {
+    std::vector<std::string_view> result;
+    if (prefix_hi.size() != lo.size()) {
+        prepare();
+    }
+    // до first все строки раньше from, начиная с last все строки позже to
+    size_t first = std::partition_point(prefix_hi.begin(), prefix_hi.end(),
+                                        [from](int t) { return t < from; }) - prefix_hi.begin();
+    size_t last = std::partition_point(suffix_lo.begin(), suffix_lo.end(),
+                                       [to](int t) { return t <= to; }) - suffix_lo.begin();
+    size_t begin = 0;
+    size_t end = 0;
+    for (size_t k = first; k < last; ++k) {
+        if (lo[k] > to || hi[k] < from) {
+            continue;
+        }
+        size_t a = line_start(text, k * size_t(step));
+        size_t b = line_start(text, (k + 1) * size_t(step));
+        if (a != end || end == 0) {
+            if (end > begin) {
+                result.push_back(text.substr(begin, end - begin));
+            }
+            begin = a;
+        }
+        end = b;
+    }
+    if (end > begin) {
+        result.push_back(text.substr(begin, end - begin));
+    }
+    return result;
+}
+
+bool TimeIndex::save(const char *path, const char *log_path, uint64_t log_size) const {
+    TimeIndexHeader header = {};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.step = step;
+    // лог успел измениться после прохода — такой индекс сразу был бы устаревшим
+    if (!source_stamp(log_path, header.source_size, header.source_mtime) || header.source_size != log_size) {
+        return false;
+    }
+    // хвостовые блоки без разобранных строк тоже записываются, чтобы число блоков задавалось размером лога
+    header.blocks = (header.source_size + step - 1) / step;
+    std::vector<int> body(lo);
+    body.resize(header.blocks, INT_MAX);
+    body.insert(body.end(), hi.begin(), hi.end());
+    body.resize(header.blocks * 2, INT_MIN);
+    header.checksum = index_checksum(reinterpret_cast<const char *>(body.data()), body.size() * sizeof(int));
+
+    std::string tmp_path = std::string(path) + ".tmp";
+    FILE *out = fopen(tmp_path.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(body.data(), sizeof(int), body.size(), out) == body.size();
+    ok = fclose(out) == 0 && ok;
+    if (!ok || rename(tmp_path.c_str(), path) != 0) {
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TimeIndex::load(const char *path, const char *log_path) {
+    MappedFile file(path);
+    if (!file.is_open() || file.size() < sizeof(TimeIndexHeader)) {
+        return false;
+    }
+    TimeIndexHeader header;
+    memcpy(&header, file.view().data(), sizeof(header));
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.step == 0 ||
+        !source_stamp(log_path, size, mtime) || header.source_size != size || header.source_mtime != mtime) {
+        return false;
+    }
+    uint64_t ints = header.blocks * 2;
+    if (header.blocks != (size + header.step - 1) / header.step ||
+        file.size() != sizeof(header) + ints * sizeof(int)) {
+        return false;
+    }
+    const char *body = file.view().data() + sizeof(header);
+    if (index_checksum(body, ints * sizeof(int)) != header.checksum) {
+        return false;
+    }
+    step = header.step;
+    lo.resize(header.blocks);
+    hi.resize(header.blocks);
+    memcpy(lo.data(), body, header.blocks * sizeof(int));
+    memcpy(hi.data(), body + header.blocks * sizeof(int), header.blocks * sizeof(int));
+    prepare();
+    return true;
+}
+
+std::string time_index_path_for(const char *log_path) {
+    return std::string(log_path) + ".tidx";
+}
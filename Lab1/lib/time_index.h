@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Разреженный индекс времени (файл <лог>.tidx). Лог режется на блоки по step байт;
+// строка относится к блоку, в котором она начинается. Для блока хранятся минимальное
+// и максимальное время его строк, поэтому --from/--to читают только блоки, чьи времена
+// пересекаются с запросом. Порядок строк в логе на правильность не влияет, а для
+// почти отсортированного лога нужные блоки идут подряд и ищутся бинарным поиском.
+class TimeIndex {
+public:
+    static constexpr uint32_t kDefaultStep = 64 << 10;
+
+    explicit TimeIndex(uint32_t step = kDefaultStep);
+
+    // строка, начинающаяся со смещения offset, имеет время time
+    void add(uint64_t offset, int time);
+    void merge(const TimeIndex &other);
+
+    // куски text (выровнены по строкам), в которых могут быть строки со временем из [from, to];
+    // соседние блоки склеиваются в один кусок
+    // text — тот лог, по которому строился индекс
+    std::vector<std::string_view> ranges(std::string_view text, long long from, long long to);
+
+    // log_size — размер лога во время прохода, которым строился индекс
+    bool save(const char *path, const char *log_path, uint64_t log_size) const;
+    // false, если файла нет, он повреждён или лог изменился после построения
+    bool load(const char *path, const char *log_path);
+
+private:
+    uint32_t step;
+    std::vector<int> lo; // пустой блок: lo > hi
+    std::vector<int> hi;
+    std::vector<int> prefix_hi; // максимум hi по блокам [0, k]
+    std::vector<int> suffix_lo; // минимум lo по блокам [k, end)
+
+    void prepare();
+};
+
+std::string time_index_path_for(const char *log_path);
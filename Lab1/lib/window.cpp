@@ -0,0 +1,80 @@
+#include "window.h"
+
+#include <algorithm>
+
+WindowSet::WindowSet(const std::vector<int> &lengths) : ring(64), left(lengths.size()), sum(lengths.size()),
+                                                        best(lengths.size()) {
+    for (size_t i = 0; i < lengths.size(); ++i) {
+        best[i].t = lengths[i];
+        if (lengths[i] > lengths[widest]) {
+            widest = i;
+        }
+    }
+}
+
+void WindowSet::grow() {
+    std::vector<Entry> bigger(ring.size() * 2);
+    for (uint64_t i = head; i < tail; ++i) {
+        bigger[i & (bigger.size() - 1)] = at(i);
+    }
+    ring.swap(bigger);
+}
+
+void WindowSet::add(int time, uint64_t count) {
+    if (best.empty()) {
+        return;
+    }
+    if (tail - head == ring.size()) {
+        grow();
+    }
+    at(tail++) = Entry{time, count};
+    for (size_t i = 0; i < best.size(); ++i) {
+        sum[i] += count;
+        while ((long long) time - at(left[i]).time > best[i].t) {
+            sum[i] -= at(left[i]).count;
+            left[i]++;
+        }
+        if (best[i].count < sum[i]) {
+            best[i].count = sum[i];
+            best[i].l = at(left[i]).time;
+            best[i].r = time;
+        }
+    }
+    // всё, что левее самого длинного окна, больше никому не нужно
+    head = left[widest];
+}
+
+LiveWindowSet::LiveWindowSet(const std::vector<int> &lengths) : lengths(lengths), done(lengths) {}
+
+std::vector<WindowSet::Result> LiveWindowSet::update(const TimeHistogram &fresh, const TimeHistogram &all) {
+    std::vector<std::pair<int, uint32_t>> entries = fresh.entries();
+    if (fed && !entries.empty() && entries.front().first <= fed_until) {
+        done = WindowSet(lengths);
+        fed = false;
+        holding = false;
+        entries = all.entries();
+    }
+    if (holding) {
+        auto it = std::lower_bound(entries.begin(), entries.end(), std::make_pair(held.first, uint32_t(0)));
+        if (it != entries.end() && it->first == held.first) {
+            it->second += held.second;
+        } else {
+            entries.insert(it, held);
+        }
+    }
+    if (entries.empty()) {
+        return done.results();
+    }
+    for (size_t i = 0; i + 1 < entries.size(); ++i) {
+        done.add(entries[i].first, entries[i].second);
+    }
+    if (entries.size() > 1) {
+        fed = true;
+        fed_until = entries[entries.size() - 2].first;
+    }
+    holding = true;
+    held = entries.back();
+    WindowSet current = done;
+    current.add(held.first, held.second);
+    return current.results();
+}
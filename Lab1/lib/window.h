@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "histogram.h"
+
+// Самые нагруженные окна сразу для нескольких длин за один проход по секундам.
+// Последние секунды лежат в кольцевом буфере, у каждой длины свой левый указатель,
+// поэтому шаг стоит O(1) амортизированно на длину и не зависит от длины окна.
+class WindowSet {
+public:
+    struct Result {
+        int t = 0;
+        uint64_t count = 0;
+        int l = 0;
+        int r = 0;
+    };
+
+    explicit WindowSet(const std::vector<int> &lengths);
+
+    // секунды должны идти строго по возрастанию
+    void add(int time, uint64_t count);
+
+    // по одному результату на длину, в порядке lengths
+    const std::vector<Result> &results() const {
+        return best;
+    }
+
+private:
+    struct Entry {
+        int time;
+        uint64_t count;
+    };
+
+    Entry &at(uint64_t i) {
+        return ring[i & (ring.size() - 1)];
+    }
+
+    void grow();
+
+    std::vector<Entry> ring;
+    uint64_t head = 0; // занято [head, tail)
+    uint64_t tail = 0;
+    std::vector<uint64_t> left;
+    std::vector<uint64_t> sum;
+    std::vector<Result> best;
+    size_t widest = 0;
+};
+
+// WindowSet для дописываемого лога (--follow): живёт между отчётами и получает только новые секунды.
+// Последняя секунда ещё может дописываться, поэтому она придерживается и к отчёту добавляется
+// в копию (копия — O(секунд в самом длинном окне)). Если пришла секунда не позже уже отданных
+// (лог не по порядку), WindowSet собирается заново по всей гистограмме.
+class LiveWindowSet {
+public:
+    explicit LiveWindowSet(const std::vector<int> &lengths);
+
+    // fresh — секунды, добавленные с прошлого вызова, all — вся гистограмма вместе с ними
+    std::vector<WindowSet::Result> update(const TimeHistogram &fresh, const TimeHistogram &all);
+
+private:
+    std::vector<int> lengths;
+    WindowSet done;
+    bool fed = false;       // в done есть секунды
+    int fed_until = 0;      // последняя секунда в done
+    bool holding = false;   // последняя секунда придержана
+    std::pair<int, uint32_t> held;
+};
@@ -1,303 +1,731 @@
+#include <csignal>
 #include <cstdio>
 #include <cstring>
+#include <ctime>
 #include <string>
-#include <fstream>
+#include <string_view>
+#include <chrono>
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/gzip.h"
+#include "lib/heavy_hitters.h"
+#include "lib/histogram.h"
+#include "lib/load_profile.h"
+#include "lib/log_index.h"
+#include "lib/mapped_file.h"
+#include "lib/output_writer.h"
+#include "lib/parser.h"
+#include "lib/request_counter.h"
+#include "lib/time_index.h"
+#include "lib/window.h"
  
 int st = 0;
 long long fin = 1e12;
  
-struct log {
-    int status = 0;
-    std::string request = "";
-    int time = 807220800; // 1 july 1995
-    std::string anlog = "";
+// план запроса: опции только собираются, а выполняются потом за один проход по файлу
+struct TArgs {
+    const char *input_path = "access_log.txt"; // первый из inputs, с ним работают --bench и index; --follow — единственный
+    std::vector<const char *> inputs;          // все входные файлы, .gz распаковываются на лету
+    std::string output_path = ""; // -o, куда писать 5xx запросы
+    bool print = false;           // -p, дублировать 5xx в stdout
+    int stats = 0;                // -s, сколько самых частых 5xx вывести
+    double approx = 0;            // --approx[=eps], приближённый -s с ошибкой eps * (число 5xx)
+    std::vector<int> windows;     // -w, длины окон в секундах (-w 60,300,3600)
+    int threads = 1;              // --threads, число потоков разбора
+    bool bench = false;
+    bool follow = false;          // --follow, следить за дописываемым логом
+    int interval = 10;            // --interval, раз в сколько секунд печатать -s/-w в режиме --follow
+    int histogram = 0;            // --histogram=sec|min|hour|N, профиль нагрузки по интервалам в N секунд
+    int histogram_top = 10;       // --histogram=min,K — сколько самых нагруженных окон вывести
+    bool make_index = false;      // index, построить <лог>.idx и выйти
+    bool no_index = false;        // --no-index, не использовать <лог>.idx даже если он есть
+};
  
-    int hash() {
-        long long p = 1;
-        long long an = 0;
-        for (int i = 0; i < request.size(); i++) {
-            an = (an * 30 + request[i]) % 999983;
+// вывод 5xx запросов в файл и/или stdout одним буфером, см. OutputWriter.
+// Ошибки записи копятся в OutputWriter, проверяются после сброса через check().
+struct ErrorWriter : OutputWriter {
+    ErrorWriter(TArgs *args) {
+        if (!args->output_path.empty() && !open_file(args->output_path.c_str())) {
+            std::cerr << "cannot open " << args->output_path << ": " << strerror(error()) << std::endl;
+        }
+        if (args->print) {
+            add_fd(STDOUT_FILENO);
+        }
+    }
+
+    // сбросить буфер; false и сообщение в stderr, если файл не открылся или запись не удалась
+    bool check() {
+        if (flush()) {
+            return true;
         }
-        return an;
+        std::cerr << "cannot write 5xx lines: " << strerror(error()) << std::endl;
+        return false;
     }
 };
- 
-struct TArgs {
-    const char *input_path = "access_log.txt";
-    char *output_path = "out.txt";
-    char *arr[20];
+
+// частичный результат одного потока по своему куску файла
+struct Partial {
+    std::string errors;
+    RequestCounter top;
+    HeavyHitters hitters;
+    TimeHistogram hist;
+    TimeIndex times;             // заполняется, только если задан base — начало файла
+    const char *base = nullptr;
+
+    Partial(double eps) : hitters(eps) {}
 };
- 
-log parse_log(std::string x) {
-    log ans;
-    for (int i = 0; i < x.size(); ++i) {
- 
-        if (x[i] == '[') {
-            if (x[i + 27] != ']') {
-                ans.status = -9;
-                return ans;
-            }
-            if (x[i + 1] == '0') {
-                ans.time += ((x[i + 2] - '0') - 1) * 24 * 60 * 60;
-            } else {
-                if (x[i + 1] - '0' < 0 || x[i + 1] - '0' > 9 || x[i + 2] - '0' < 0 || x[i + 2] - '0' > 9) {
-                    ans.status = -9;
-                    return ans;
-                }
-                ans.time += ((10 * (x[i + 1] - '0')) + (x[i + 2] - '0') - 1) * 24 * 60 * 60;
-            }
- 
-            if (x[i + 13] == '0') {
-                ans.time += (x[i + 14] - '0') * 60 * 60;
-            } else {
-                if (x[i + 13] - '0' < 0 || x[i + 14] - '0' > 9 || x[i + 14] - '0' < 0 || x[i + 13] - '0' > 9) {
-                    ans.status = -9;
-                    return ans;
-                }
-                ans.time += ((10 * (x[i + 13] - '0')) + (x[i + 14] - '0') - 1) * 60 * 60;
-            }
- 
- 
-            if (x[i + 16] == '0') {
-                ans.time += (x[i + 17] - '0') * 60;
-            } else {
- 
-                if (x[i + 16] - '0' < 0 || x[i + 16] - '0' > 9 || x[i + 17] - '0' < 0 || x[i + 17] - '0' > 9) {
-                    ans.status = -9;
-                    return ans;
-                }
-                ans.time += ((10 * (x[i + 16] - '0')) + (x[i + 17] - '0') - 1) * 60;
+
+// куски файла по числу потоков, границы сдвинуты на начало строки
+std::vector<std::string_view> split_chunks(std::string_view text, int n) {
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    for (int k = 1; k <= n; ++k) {
+        size_t end = k == n ? text.size() : std::max(begin, text.size() / n * k);
+        if (end < text.size()) {
+            size_t nl = text.find('\n', end);
+            end = nl == std::string_view::npos ? text.size() : nl + 1;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+// direct != nullptr только у первого куска: его 5xx можно писать сразу, порядок не нарушится
+void scan(std::string_view chunk, TArgs *args, Partial &part, ErrorWriter *direct) {
+    LineReader reader(chunk);
+    std::string_view line;
+    bool errors = args->print || !args->output_path.empty();
+    while (reader.next(line)) {
+        log cur = parse_log(line);
+        if (cur.status == -9) {
+            continue;
+        }
+        if (part.base) {
+            part.times.add(line.data() - part.base, cur.time);
+        }
+        if (cur.time < st || cur.time > fin) {
+            continue;
+        }
+        if (cur.status / 100 == 5) {
+            if (direct && errors) {
+                direct->add(line);
+            } else if (errors) {
+                part.errors.append(line);
+                part.errors.push_back('\n');
             }
- 
- 
-            if (x[i + 19] == '0') {
-                ans.time += x[i + 20] - '0';
-            } else {
- 
-                if (x[i + 19] - '0' < 0 || x[i + 19] - '0' > 5 || x[i + 20] - '0' < 0 || x[i + 20] - '0' > 9) {
-                    ans.status = -9;
-                    return ans;
+            if (args->stats > 0) {
+                if (args->approx > 0) {
+                    part.hitters.add(cur.request);
+                } else {
+                    part.top.add(cur.request);
                 }
-                ans.time += ((10 * (x[i + 19] - '0')) + (x[i + 20] - '0') - 1);
             }
- 
- 
-            break;
+        }
+        if (!args->windows.empty() || args->histogram > 0) {
+            part.hist.add(cur.time);
         }
     }
- 
-    int cnt = 0;
-    std::string st;
-    std::string rq;
-    std::string namelog;
-    for (int i = x.size() - 1; i >= 0; --i) {
-        if (x[i] == ' ')
-            cnt += 1;
-        else if (cnt == 1) {
-            st = x[i] + st;
+}
+
+// --histogram: пик, перцентили запросов на интервал и самые нагруженные окна
+// (длины окон из -w, без -w — по одному интервалу)
+void print_profile(TArgs *args, const TimeHistogram &hist) {
+    LoadProfile profile(hist, args->histogram);
+    int g = profile.granularity();
+    LoadProfile::Window peak = profile.peak();
+    std::cout << "histogram " << g << "s: " << profile.size() << " intervals from " << profile.start() << std::endl;
+    std::cout << "peak " << peak.count << " at " << peak.begin << std::endl;
+    std::cout << "p50 " << profile.percentile(50) << " p95 " << profile.percentile(95)
+              << " p99 " << profile.percentile(99) << std::endl;
+    std::vector<int> lengths = args->windows;
+    if (lengths.empty()) {
+        lengths.push_back(g);
+    }
+    for (int length: lengths) {
+        size_t intervals = (length + g - 1) / g;
+        std::cout << "busiest " << intervals * g << "s:" << std::endl;
+        for (const LoadProfile::Window &w: profile.busiest(intervals, args->histogram_top)) {
+            std::cout << w.begin << ' ' << w.count << std::endl;
         }
-        if (cnt == 2 || cnt == 3) {
-            rq = x[i] + rq;
+    }
+}
+
+// -w по всей гистограмме за один проход
+std::vector<WindowSet::Result> busiest_windows(TArgs *args, const TimeHistogram &hist) {
+    if (args->windows.empty()) {
+        return {};
+    }
+    WindowSet okno(args->windows);
+    for (const auto &[time, count]: hist.entries()) {
+        okno.add(time, count);
+    }
+    return okno.results();
+}
+
+// вывод -s и -w: top — самые частые 5xx из точного счётчика, windows — по окну на длину из -w
+void report(TArgs *args, const std::vector<std::pair<std::string_view, uint64_t>> &top, const HeavyHitters &hitters,
+            const std::vector<WindowSet::Result> &windows, const TimeHistogram &hist) {
+    if (args->stats > 0 && args->approx > 0) {
+        // оценка завышена не больше чем на ±error
+        for (const HeavyHitters::Item &item: hitters.top(args->stats)) {
+            std::cout << item.request << ' ' << item.count << " ±" << item.error << std::endl;
+        }
+    } else if (args->stats > 0) {
+        for (const auto &[request, count]: top) {
+            std::cout << request << std::endl;
         }
     }
-    if (st.size() == 0 || rq.size() == 0) {
-        ans.status = -9;
-        return ans;
+    // окно [l, l + t] с максимумом запросов, печатается первая и последняя секунда с запросами
+    for (const WindowSet::Result &res: windows) {
+        std::cout << res.l << ' ' << res.r << std::endl;
     }
-    int k = 0;
-    while (x[k] != ' ') {
-        namelog = namelog + x[k];
-        k++;
+    if (args->histogram > 0) {
+        print_profile(args, hist);
     }
- 
-    //std::cout << 88 << std::endl;
-    ans.status = stoi(st);
-    ans.request = rq;
-    ans.anlog = namelog;
-    return ans;
 }
- 
-void stats(TArgs *args, int n) { //req_f
-    std::ifstream in(args->input_path);
-    std::ofstream out(args->output_path);
-    std::string line;
-    std::vector<std::pair<int, std::string>> data(1000000);
-    int ll = 0;
-    while (std::getline(in, line)) {
- 
-        log cur = parse_log(line);
-        if (cur.time < st || cur.time > fin) {
+
+// -s и -w по колоночному индексу: строки лога не разбираются, запросы считаются по номерам в словаре
+void run_indexed(TArgs *args, const LogIndex &index, Partial &total) {
+    const int32_t *times = index.times();
+    const uint16_t *statuses = index.statuses();
+    const uint32_t *requests = index.requests();
+    std::vector<uint64_t> counts(args->stats > 0 && args->approx <= 0 ? index.request_count() : 0);
+    for (uint64_t i = 0; i < index.rows(); ++i) {
+        if (times[i] < st || times[i] > fin) {
             continue;
         }
-        if (cur.status / 100 == 5) {
-            data[cur.hash()].first++;
-            data[cur.hash()].second = cur.request; //вся строка = line
+        if (statuses[i] / 100 == 5 && args->stats > 0) {
+            if (args->approx > 0) {
+                total.hitters.add(index.request(requests[i]));
+            } else {
+                counts[requests[i]]++;
+            }
+        }
+        if (!args->windows.empty() || args->histogram > 0) {
+            total.hist.add(times[i]);
+        }
+    }
+    for (uint32_t id = 0; id < counts.size(); ++id) {
+        if (counts[id] > 0) {
+            total.top.add(index.request(id), counts[id]);
         }
-        
     }
+}
 
-    if (data.size() == 0) {
-        printf("error stats");
-        return;
+// index: колоночный кэш рядом с логом для повторных запросов
+bool write_index(TArgs *args) {
+    std::string path = index_path_for(args->input_path);
+    MappedFile probe(args->input_path);
+    if (probe.is_open() && is_gzip(probe.view())) {
+        std::cerr << "index: " << args->input_path << " is compressed, index the plain log instead" << std::endl;
+        return false;
+    }
+    std::string error;
+    uint64_t rows = 0;
+    TimeIndex times;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (!source_stamp(args->input_path, size, mtime) ||
+        !build_index(args->input_path, path.c_str(), error, &rows, &times)) {
+        std::cerr << "index: " << error << std::endl;
+        return false;
     }
-    std::sort(data.begin(), data.end());
-    std::reverse(data.begin(), data.end());
-    for (int i = 0; i < std::min(n, (int) data.size()); ++i) {
-        out << data[i].second << std::endl;
+    std::cout << path << ": " << rows << " rows" << std::endl;
+    std::string times_path = time_index_path_for(args->input_path);
+    if (!times.save(times_path.c_str(), args->input_path, size)) {
+        std::cerr << "index: cannot write " << times_path << std::endl;
+        return false;
     }
-    in.close();
-    out.close();
+    std::cout << times_path << std::endl;
+    return true;
 }
- 
-void okno(TArgs *args, int t) {
-    //std::cout << t << std::endl;
-    int ans = 0;
-    int l = 0, r = 0;
-    std::vector<int> window;
-    std::fstream in(args->input_path);
+
+void merge_into(Partial &total, Partial &part, ErrorWriter &writer) {
+    writer.add_block(part.errors);
+    total.top.merge(part.top);
+    total.hitters.merge(part.hitters);
+    total.hist.merge(part.hist);
+}
+
+// .gz: вызывающий поток распаковывает и режет поток на куски по границам строк,
+// --threads потоков (минимум один) их разбирают; 5xx строки пишутся в порядке кусков
+bool run_gzip(TArgs *args, const char *path, std::string_view data, ErrorWriter &writer, Partial &total) {
+    const size_t chunk_size = 1 << 20;
+    size_t n = std::max(1, args->threads);
+    std::mutex lock;
+    std::condition_variable ready;
+    std::condition_variable room;
+    std::deque<std::pair<size_t, std::string>> queue; // не больше 2n кусков ждут разбора
+    bool finished = false;
+    std::map<size_t, std::string> pending; // 5xx строки кусков, обогнавших очередь вывода
+    size_t next_out = 0;
+
+    std::vector<Partial> parts;
+    parts.reserve(n);
+    for (size_t k = 0; k < n; ++k) {
+        parts.emplace_back(args->approx);
+    }
+    auto parse = [&](Partial &part) {
+        while (true) {
+            std::pair<size_t, std::string> chunk;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                ready.wait(guard, [&] { return !queue.empty() || finished; });
+                if (queue.empty()) {
+                    return;
+                }
+                chunk = std::move(queue.front());
+                queue.pop_front();
+            }
+            room.notify_one();
+            part.errors.clear();
+            scan(chunk.second, args, part, nullptr);
+            std::lock_guard<std::mutex> guard(lock);
+            pending[chunk.first] = std::move(part.errors);
+            for (auto it = pending.begin(); it != pending.end() && it->first == next_out; it = pending.erase(it)) {
+                writer.add_block(it->second);
+                next_out++;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (Partial &part: parts) {
+        workers.emplace_back(parse, std::ref(part));
+    }
+
+    size_t seq = 0;
+    std::string current;
+    auto push = [&](std::string text) {
+        std::unique_lock<std::mutex> guard(lock);
+        room.wait(guard, [&] { return queue.size() < 2 * n; });
+        queue.emplace_back(seq++, std::move(text));
+        guard.unlock();
+        ready.notify_one();
+    };
+    std::string error;
+    bool ok = gunzip(data, [&](std::string_view bytes) {
+        current.append(bytes);
+        if (current.size() >= chunk_size) {
+            size_t end = current.rfind('\n');
+            if (end != std::string::npos) {
+                std::string rest = current.substr(end + 1);
+                current.resize(end + 1);
+                push(std::move(current));
+                current = std::move(rest);
+            }
+        }
+        return true;
+    }, error);
+    if (ok && !current.empty()) {
+        push(std::move(current));
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        finished = true;
+    }
+    ready.notify_all();
+    for (std::thread &w: workers) {
+        w.join();
+    }
+    if (!ok) {
+        std::cerr << path << ": " << error << std::endl;
+        return false;
+    }
+    for (Partial &part: parts) {
+        part.errors.clear(); // уже записаны в порядке кусков
+        merge_into(total, part, writer);
+    }
+    return true;
+}
+
+// один проход по файлу, который кормит все запрошенные анализы сразу;
+// при --threads N файл режется на N кусков, результаты сливаются в порядке кусков
+bool run_file(TArgs *args, const char *path, ErrorWriter &writer, Partial &total) {
+    // строки 5xx целиком есть только в самом логе, поэтому индекс годится лишь для -s и -w
+    if (!args->no_index && args->output_path.empty() && !args->print) {
+        std::string index_path = index_path_for(path);
+        LogIndex index(index_path.c_str());
+        std::string reason;
+        if (index.is_open() && index.fresh_for(path, reason)) {
+            run_indexed(args, index, total);
+            return true;
+        }
+        if (index.is_open()) {
+            std::cerr << index_path << " ignored: " << reason << std::endl;
+        }
+    }
+    MappedFile in(path);
     if (!in.is_open()) {
-        std::cout << "error";
-        return;
+        printf("error file is crashed");
+        return false;
     }
-    window.push_back(1);
-   // int o = 100;
-    while (true) {
-       // o++;
-        if (window.back() - window.front() > t) {
-            window.erase(window.begin());
+    if (is_gzip(in.view())) {
+        return run_gzip(args, path, in.view(), writer, total);
+    }
+    // с --from/--to читаются только блоки файла, чьи времена попадают в отрезок; если индекса
+    // времени ещё нет, он собирается этим же проходом и сохраняется рядом с логом
+    std::vector<std::string_view> pieces = {in.view()};
+    bool collect_times = false;
+    std::string times_path = time_index_path_for(path);
+    if (!args->no_index && (st != 0 || fin != (long long) 1e12)) {
+        TimeIndex times;
+        if (times.load(times_path.c_str(), path)) {
+            pieces = times.ranges(in.view(), st, fin);
         } else {
-            std::string x;
-            if (!std::getline(in, x)) {
-                break;
+            collect_times = true;
+        }
+    }
+    size_t n = std::max(1, args->threads);
+    if (pieces.size() < n) {
+        std::vector<std::string_view> split;
+        for (std::string_view piece: pieces) {
+            for (std::string_view chunk: split_chunks(piece, n)) {
+                split.push_back(chunk);
             }
-            if (ans < window.size()) {
-         		 ans = window.size();
-                 //std::cout << window.back() << ' ' <<  window.front() << ' ' << window.back() - window.front() << ' ' << x << std::endl;
-           		 l = window.front();
-           		 r = window.back();
-        	}
-            log a = parse_log(x);
-            if (a.time < st || a.time > fin)continue;
-            //std::cout <<window.front() << ' ' << window.back()<<std::endl;
-            window.push_back(a.time);
- 			
-        }
-        //if(o == 20000)break;
- 
+        }
+        pieces = split;
+    }
+
+    // поток g разбирает подряд идущие куски, поэтому слияние по порядку потоков сохраняет порядок строк
+    size_t groups = std::min(n, pieces.size());
+    std::vector<Partial> parts;
+    parts.reserve(groups);
+    for (size_t g = 0; g < groups; ++g) {
+        parts.emplace_back(args->approx);
+        parts.back().base = collect_times ? in.view().data() : nullptr;
+    }
+    auto scan_group = [&](size_t g) {
+        for (size_t k = pieces.size() * g / groups; k < pieces.size() * (g + 1) / groups; ++k) {
+            scan(pieces[k], args, parts[g], g == 0 ? &writer : nullptr);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t g = 1; g < groups; ++g) {
+        workers.emplace_back(scan_group, g);
     }
-    std::cout << l << ' ' << r;
+    if (groups > 0) {
+        scan_group(0);
+    }
+    for (std::thread &w: workers) {
+        w.join();
+    }
+
+    TimeIndex times;
+    for (Partial &part: parts) {
+        merge_into(total, part, writer);
+        times.merge(part.times);
+    }
+    if (collect_times) {
+        times.save(times_path.c_str(), path, in.size()); // не вышло — в следующий раз соберётся снова
+    }
+    return true;
 }
- 
-void time_st(int t) {
-    st = t;
+
+// все входные файлы по очереди, отчёт -s/-w один на всех
+bool run(TArgs *args) {
+    ErrorWriter writer(args);
+    if (!writer.ok()) {
+        return false;
+    }
+    Partial total(args->approx);
+    for (const char *path: args->inputs) {
+        if (!run_file(args, path, writer, total)) {
+            return false;
+        }
+    }
+    // -p и отчёт идут в один stdout: строки 5xx должны выйти раньше
+    if (!writer.check()) {
+        return false;
+    }
+    report(args, total.top.top(args->stats), total.hitters, busiest_windows(args, total.hist), total.hist);
+    return true;
 }
- 
-void time_fin(int t) {
-    fin = t;
+
+volatile std::sig_atomic_t stop_follow = 0;
+
+// --follow: лог только дописывается, поэтому читаются лишь новые байты, а счётчики живут
+// между чтениями. Ротация видна по смене inode (старый файл дочитывается) или по уменьшению размера.
+// Отчёт не пересчитывается по всей истории: -s смотрит на прежних лидеров и запросы с прошлого
+// отчёта, -w досчитывает окна по новым секундам (см. RequestCounter::top, LiveWindowSet).
+bool follow(TArgs *args) {
+    std::signal(SIGINT, [](int) { stop_follow = 1; });
+    std::signal(SIGTERM, [](int) { stop_follow = 1; });
+    ErrorWriter writer(args);
+    if (!writer.ok()) {
+        return false;
+    }
+    Partial tick(args->approx); // разобранное с прошлого отчёта; сводка --approx живёт здесь всё время
+    RequestCounter top;         // всё, что было до прошлого отчёта включительно
+    TimeHistogram hist;
+    std::vector<std::string> leaders; // прошлый ответ -s
+    LiveWindowSet windows(args->windows);
+    auto print_report = [&]() {
+        top.merge(tick.top);
+        hist.merge(tick.hist);
+        std::vector<std::pair<std::string_view, uint64_t>> best = top.top(args->stats, leaders, tick.top);
+        leaders.clear();
+        for (const auto &[request, count]: best) {
+            leaders.emplace_back(request);
+        }
+        std::vector<WindowSet::Result> busiest;
+        if (!args->windows.empty()) {
+            busiest = windows.update(tick.hist, hist);
+        }
+        std::cout << "-- " << std::time(nullptr) << std::endl;
+        report(args, best, tick.hitters, busiest, hist);
+        tick.top = RequestCounter();
+        tick.hist = TimeHistogram();
+    };
+    std::string carry; // новые байты до последнего '\n', хвост ждёт следующего чтения
+    std::vector<char> buf(1 << 20);
+    int fd = -1;
+    ino_t inode = 0;
+    off_t offset = 0;
+    // новые байты до конца файла, но не дольше deadline (хотя бы один буфер), чтобы отчёт
+    // --interval выходил и у непрерывно растущего лога; false, если до конца не дочитали
+    auto drain = [&](std::chrono::steady_clock::time_point deadline, bool &got) {
+        ssize_t n;
+        while (!stop_follow && (n = pread(fd, buf.data(), buf.size(), offset)) > 0) {
+            offset += n;
+            got = true;
+            carry.append(buf.data(), n);
+            size_t end = carry.rfind('\n');
+            if (end != std::string::npos) {
+                scan(std::string_view(carry).substr(0, end + 1), args, tick, &writer);
+                carry.erase(0, end + 1);
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto last_report = std::chrono::steady_clock::now();
+    while (!stop_follow) {
+        auto deadline = last_report + std::chrono::seconds(args->interval);
+        bool got = false;
+        bool done = true; // старый файл дочитан, можно переключаться на новый
+        struct stat info;
+        if (stat(args->input_path, &info) == 0) {
+            bool rotated = fd >= 0 && info.st_ino != inode;
+            bool truncated = fd >= 0 && !rotated && info.st_size < offset;
+            if (rotated) {
+                done = drain(deadline, got); // не дочитали — продолжим после отчёта
+            }
+            if (done && (fd < 0 || rotated || truncated)) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+                // старый лог дочитан: его последняя строка без '\n' уже не допишется
+                if (rotated && !carry.empty()) {
+                    scan(carry, args, tick, &writer);
+                }
+                fd = open(args->input_path, O_RDONLY);
+                inode = info.st_ino;
+                offset = 0;
+                carry.clear();
+            }
+        }
+        if (done && fd >= 0) {
+            drain(deadline, got);
+        }
+        // демон показывает новые 5xx строки сразу, одной записью на опрос
+        if (!writer.check()) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_report >= std::chrono::seconds(args->interval)) {
+            print_report();
+            last_report = now;
+        }
+        if (!got) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    print_report();
+    return true;
 }
- 
-void print(TArgs *args) {
- 
-    std::string line;
-    std::ifstream in(
-            args->output_path); // открываем файл вывода, чтобы потом дублировать вывод запросов из него(то, что было в output)
+
+// --bench: один проход чтение + разбор, печатает скорость
+void bench(TArgs *args) {
+    auto begin = std::chrono::steady_clock::now();
+    MappedFile in(args->input_path);
     if (!in.is_open()) {
-        printf("error file is crashed");
+        printf("error bench");
         return;
     }
-    int c = 0;
-    while (std::getline(in, line)) {
-        c++;
-        if (c > st && c < fin)
-            std::cout << line << std::endl;
+    LineReader reader(in.view());
+    std::string_view line;
+    long long lines = 0;
+    long long checksum = 0;
+    while (reader.next(line)) {
+        log cur = parse_log(line);
+        checksum += cur.status + cur.time;
+        lines++;
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (sec <= 0) {
+        sec = 1e-9;
     }
-    in.close();
+    std::cout << "lines: " << lines << ", bytes: " << in.size() << ", time: " << sec << " s\n"
+              << "lines/sec: " << (long long) (lines / sec) << ", bytes/sec: " << (long long) (in.size() / sec)
+              << " (checksum " << checksum << ")" << std::endl;
 }
- 
-void file_path(TArgs *args, std::string path) { 
-    args->output_path = &path[0];
+
+// "60,300,3600" -> несколько окон за тот же проход; 0 - окно не считается
+void read_windows(TArgs *args, const char *list) {
+    for (const char *p = list; *p;) {
+        int t = atoi(p);
+        if (t > 0) {
+            args->windows.push_back(t);
+        }
+        p = strchr(p, ',');
+        if (!p) {
+            break;
+        }
+        p++;
+    }
 }
- 
-// ?|^ передает путь к файлу
+
+// --histogram=min или --histogram=300,5: длина интервала и число окон в отчёте
+bool read_histogram(TArgs *args, const std::string &value) {
+    size_t comma = value.find(',');
+    std::string unit = value.substr(0, comma);
+    if (unit == "sec" || unit == "s") {
+        args->histogram = 1;
+    } else if (unit == "min" || unit == "m") {
+        args->histogram = 60;
+    } else if (unit == "hour" || unit == "h") {
+        args->histogram = 3600;
+    } else {
+        args->histogram = atoi(unit.c_str());
+    }
+    if (comma != std::string::npos) {
+        args->histogram_top = atoi(value.c_str() + comma + 1);
+    }
+    return args->histogram > 0;
+}
+
+// разбирает опции в план, сам ничего не считает
 bool ReadArgs(TArgs *args, int argc, char *argv[]) {
-    std::string nazvanie = "";
-    std::string chislo = "";
-    for (int i = 1; i < argc - 1; ++i) {
-        
-        if (strcmp(args->arr[1], "AnalyzeLog") != 0) {
-            printf("error input readArgs");
-            return false;
-        }
-        if (i == 1)
+    for (int i = 1; i < argc; ++i) {
+        if (i == 1 && strcmp(argv[i], "AnalyzeLog") == 0)
             continue;
-        if (strcmp(argv[i], "-o") == 0) {
-            file_path(args, args->arr[i + 1]);
-            i++;
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "-o") == 0 && has_value) {
+            args->output_path = argv[++i];
         } else if (strcmp(argv[i], "-p") == 0 or strcmp(argv[i], "--print") == 0) {
-            print(args);
-        } else if (strcmp(argv[i], "-s") == 0) {
-            stats(args, atoi(args->arr[i + 1]));
-            i++;
-        } else if (strcmp(argv[i], "-w") == 0) {
-            okno(args, atoi(args->arr[i + 1]));
-            i++;
-        } else if (strcmp(argv[i], "-f") == 0) {
-            st = atoi(args->arr[i + 1]);
-            i++;
-        } else if (strcmp(argv[i], "-e") == 0) {
-            fin = atoi(args->arr[i + 1]);
-            i++;
+            args->print = true;
+        } else if (strcmp(argv[i], "--approx") == 0) {
+            args->approx = 1e-4;
+        } else if (strcmp(argv[i], "index") == 0) {
+            args->make_index = true;
+        } else if (strcmp(argv[i], "--no-index") == 0) {
+            args->no_index = true;
+        } else if (strcmp(argv[i], "--follow") == 0) {
+            args->follow = true;
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            args->bench = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+            args->threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && has_value) {
+            args->stats = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && has_value) {
+            read_windows(args, argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && has_value) {
+            st = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-e") == 0 && has_value) {
+            fin = atoll(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            args->inputs.push_back(argv[i]);
         } else {
-            int raw = 0;
-            for (int x = 0; x < strlen(args->arr[i]); x++) {
-                if (raw) {
-                    chislo = chislo + args->arr[i][x];
-                } else {
-                    nazvanie = nazvanie + args->arr[i][x];
-                }
-                if (args->arr[i][x] == '=')
-                raw = 1;
+            std::string arg = argv[i];
+            size_t eq = arg.find('=');
+            if (eq == std::string::npos) {
+                return false;
             }
+            std::string nazvanie = arg.substr(0, eq + 1);
+            std::string chislo = arg.substr(eq + 1);
             if (nazvanie == "--output=") {
-                file_path(args, chislo);
+                args->output_path = chislo;
             } else if (nazvanie == "--stats=") {
-                stats(args, stoi(chislo));
+                args->stats = atoi(chislo.c_str());
             } else if (nazvanie == "--window=") {
-                okno(args, stoi(chislo));
+                read_windows(args, chislo.c_str());
+            } else if (nazvanie == "--approx=") {
+                args->approx = atof(chislo.c_str());
+            } else if (nazvanie == "--histogram=") {
+                if (!read_histogram(args, chislo)) {
+                    return false;
+                }
+            } else if (nazvanie == "--interval=") {
+                args->interval = std::max(1, atoi(chislo.c_str()));
+            } else if (nazvanie == "--threads=") {
+                args->threads = atoi(chislo.c_str());
             } else if (nazvanie == "--from=") {
-                st = stoi(chislo);
+                st = atoi(chislo.c_str());
             } else if (nazvanie == "--to=") {
-                fin = stoi(chislo);
+                fin = atoll(chislo.c_str());
             } else {
                 return false;
             }
- 
         }
- 
     }
+    // --approx меняет только -s, без него он молча ничего бы не делал
+    if (args->approx > 0 && args->stats <= 0) {
+        std::cerr << "--approx needs -s" << std::endl;
+        return false;
+    }
+    return true;
 }
  
  
 int main(int argc, char *argv[]) {
     TArgs args;
-    for (int i = 0; i < argc; ++i) {
-        args.arr[i] = argv[i];
+    //AnalyzeLog -f 66 -e 778777878878 -s 1000 access_log.txt
+    //AnalyzeLog -w 1000 access_log.txt access_log.1.gz access_log.2.gz
+    //a AnalyzeLog --stats=10000 access_log.txt
+    if (!ReadArgs(&args, argc, argv) || args.inputs.empty()) {
+        printf("error input readArgs");
+        return 1;
     }
-    if (strcmp(argv[argc - 1], "access_log.txt") != 0) {
-        printf("error");
+    args.input_path = args.inputs[0];
+    if (args.follow && args.inputs.size() > 1) {
+        std::cerr << "--follow watches a single log, got " << args.inputs.size() << " input files" << std::endl;
         return 1;
     }
- 
-    //AnalyzeLog -f 66 -e 778777878878 -s 1000 access_log.txt
-    //AnalyzeLog -w 1000 access_log.txt
-    //a AnalyzeLog --stats=10000 access_log.txt
-    if (!ReadArgs(&args, argc, argv)) {
- 
+    if (args.make_index) {
+        return write_index(&args) ? 0 : 1;
+    }
+    if (args.bench) {
+        bench(&args);
+    }
+    if (args.follow) {
+        return follow(&args) ? 0 : 1;
+    }
+    if (!run(&args)) {
         return 1;
     }
  
    return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,20 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "test_util.h"
+
+
+// --approx без -s ничего бы не изменил, поэтому отклоняется
+TEST(CliTest, RejectsApproxWithoutStats) {
+    TempDir dir;
+    std::string log_path = dir.file("access.log");
+    write_file(log_path, test_log(200, 3));
+    for (const char *options: {"--approx ", "--approx=0.01 ", "--approx -w 60 "}) {
+        CliResult result = run_analyzelog(options + log_path, dir);
+        ASSERT_EQ(result.status, 1) << options;
+        ASSERT_NE(result.err.find("--approx needs -s"), std::string::npos) << options;
+    }
+    CliResult approx = run_analyzelog("--approx -s 3 " + log_path, dir);
+    ASSERT_EQ(approx.status, 0);
+    ASSERT_NE(approx.out, "");
+}
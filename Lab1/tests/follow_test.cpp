@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <thread>
+
+#include <signal.h>
+
+#include "test_util.h"
+
+
+namespace {
+
+const char *kOld = "a.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /old HTTP/1.0\" 500 1\n"
+                   "a.example.com - - [01/Jul/1995:00:00:02 -0400] \"GET /tail HTTP/1.0\" 503 1"; // без '\n'
+const char *kNew = "b.example.com - - [01/Jul/1995:00:00:03 -0400] \"GET /new HTTP/1.0\" 502 1\n";
+
+// ждёт, пока файл станет равен want, не дольше 10 секунд
+bool wait_for(const std::string &path, const std::string &want) {
+    for (int i = 0; i < 100; ++i) {
+        if (read_file(path) == want) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return false;
+}
+
+} // namespace
+
+
+// после ротации последняя строка старого лога без '\n' не теряется
+TEST(FollowTest, KeepsLastLineOfRotatedLog) {
+    TempDir dir;
+    std::string log_path = dir.file("access.log"), out = dir.file("out.txt");
+    write_file(log_path, kOld);
+    std::string command = std::string(ANALYZELOG_BIN) + " --follow --interval=1 -o " + out + " " + log_path +
+                          " >" + dir.file("stdout.txt") + " 2>&1 & echo $! >" + dir.file("pid");
+    ASSERT_EQ(std::system(command.c_str()), 0);
+    pid_t pid = std::stoi(read_file(dir.file("pid")));
+
+    std::string first = std::string(kOld).substr(0, std::string(kOld).find('\n') + 1);
+    bool read_old = wait_for(out, first);
+    std::filesystem::rename(log_path, log_path + ".1");
+    write_file(log_path, kNew);
+    bool rotated = wait_for(out, first + "a.example.com - - [01/Jul/1995:00:00:02 -0400] \"GET /tail HTTP/1.0\" 503 1\n" +
+                                 kNew);
+    kill(pid, SIGTERM);
+    for (int i = 0; i < 100 && kill(pid, 0) == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    ASSERT_TRUE(read_old) << read_file(out);
+    ASSERT_TRUE(rotated) << read_file(out);
+}
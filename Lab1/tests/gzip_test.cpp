@@ -0,0 +1,204 @@
+#include <lib/gzip.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+
+namespace {
+
+// потоки собраны zlib (уровень 9, mtime 0)
+// fixed Huffman (BTYPE = 1): "fixed huffman" три раза и перевод строки
+const unsigned char kFixed[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x4b, 0xcb, 0xac, 0x48, 0x4d, 0x51,
+    0xc8, 0x28, 0x4d, 0x4b, 0xcb, 0x4d, 0xcc, 0x53, 0x48, 0xc3, 0xcd, 0xe3, 0x02, 0x00, 0xf0, 0x53,
+    0x17, 0x67, 0x2a, 0x00, 0x00, 0x00,
+};
+
+// dynamic Huffman (BTYPE = 2): dynamic_plain()
+const unsigned char kDynamic[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0xd5, 0xb1, 0x4e, 0x43, 0x31,
+    0x0c, 0x85, 0xe1, 0xbd, 0x4f, 0x71, 0xd5, 0xbd, 0xbd, 0xb6, 0x63, 0xc7, 0x31, 0x3b, 0x02, 0x31,
+    0x31, 0x74, 0x43, 0x0c, 0x0c, 0x88, 0x0e, 0x45, 0x20, 0x51, 0xde, 0x9f, 0xea, 0x32, 0xc6, 0x71,
+    0xac, 0x64, 0x8c, 0xbe, 0xe9, 0x3f, 0xca, 0xf9, 0xeb, 0xe7, 0x0a, 0xcb, 0xe1, 0x76, 0x5e, 0x00,
+    0xd7, 0xa7, 0xdf, 0xcb, 0x8a, 0x66, 0x72, 0x07, 0xf0, 0x7f, 0x97, 0x03, 0x30, 0xc0, 0xeb, 0xb2,
+    0x7f, 0xb8, 0x3f, 0x2d, 0xeb, 0xf7, 0xdb, 0xc7, 0x3b, 0x1c, 0xcf, 0xd7, 0xcf, 0xcb, 0xf2, 0x78,
+    0x3a, 0x3d, 0xaf, 0x78, 0x84, 0xfd, 0x42, 0xb7, 0x57, 0xb0, 0x3b, 0xdf, 0x1c, 0x1c, 0x3a, 0xd8,
+    0x3b, 0xe8, 0x39, 0x45, 0x37, 0x88, 0x86, 0x10, 0xf5, 0x10, 0x79, 0x90, 0xf2, 0x06, 0x95, 0x21,
+    0x54, 0x7a, 0xa8, 0x78, 0x10, 0x22, 0x6e, 0x12, 0x0f, 0x25, 0xee, 0x25, 0x76, 0x25, 0x6e, 0x9b,
+    0x24, 0x43, 0x49, 0x7a, 0x49, 0x5c, 0xa9, 0xc9, 0x26, 0xd5, 0xa1, 0x54, 0x7b, 0xa9, 0x7a, 0x12,
+    0x11, 0x6d, 0xd2, 0xb8, 0x00, 0xed, 0x25, 0x75, 0x25, 0xb1, 0x49, 0x03, 0xad, 0x97, 0x9a, 0x2b,
+    0x59, 0x9d, 0x44, 0x60, 0xbd, 0x64, 0x6e, 0x4d, 0xa5, 0xc4, 0x15, 0xa0, 0xd3, 0x37, 0x82, 0x1f,
+    0x26, 0xc4, 0x19, 0xa0, 0x97, 0xb8, 0xdb, 0x38, 0x83, 0xc6, 0x1d, 0xa0, 0x13, 0x39, 0xba, 0x95,
+    0x33, 0x73, 0x1c, 0x02, 0x96, 0xe4, 0x80, 0xb9, 0x61, 0x1c, 0x02, 0x72, 0x72, 0xc2, 0x82, 0x2d,
+    0x0e, 0x01, 0x25, 0xb9, 0x61, 0x11, 0x89, 0x43, 0xc0, 0x9a, 0x1c, 0xb1, 0x18, 0x4d, 0x42, 0xd0,
+    0xe4, 0x88, 0x2b, 0xd9, 0xa4, 0x83, 0x96, 0x1c, 0x71, 0xad, 0x75, 0x92, 0x81, 0x25, 0x47, 0xac,
+    0x50, 0xe2, 0x0a, 0x08, 0x92, 0x23, 0x56, 0x86, 0xb8, 0x02, 0xc2, 0xe4, 0x88, 0x55, 0x35, 0xae,
+    0x80, 0x28, 0x39, 0xe2, 0x86, 0x1c, 0x57, 0x40, 0x25, 0x3b, 0xe2, 0x26, 0x18, 0x67, 0x40, 0x9c,
+    0x1d, 0x71, 0x6b, 0x2d, 0xee, 0x80, 0x24, 0x3b, 0x62, 0x23, 0x89, 0x43, 0xa0, 0x9a, 0x1c, 0xb1,
+    0x55, 0x9a, 0x84, 0xa0, 0xc9, 0x11, 0x9b, 0xd9, 0x24, 0x84, 0x96, 0x1c, 0x31, 0x42, 0xa9, 0x93,
+    0x12, 0x2c, 0xfb, 0x15, 0x83, 0x96, 0xdd, 0x1f, 0x69, 0x5b, 0xf5, 0x65, 0xb0, 0x08, 0x00, 0x00,
+};
+
+std::string fixed_plain() {
+    return "fixed huffman fixed huffman fixed huffman\n";
+}
+
+std::string dynamic_plain() {
+    std::string text;
+    for (int i = 0; i < 30; ++i) {
+        char line[128];
+        snprintf(line, sizeof(line), "host%d - - [01/Jul/1995:00:00:%02d -0400] \"GET /page%d.html HTTP/1.0\" 200 %d\n",
+                 i % 7, i % 60, i % 13, i * 37);
+        text += line;
+    }
+    return text;
+}
+
+std::string bytes(const unsigned char *data, size_t size) {
+    return std::string(reinterpret_cast<const char *>(data), size);
+}
+
+uint32_t crc32(std::string_view text) {
+    uint32_t crc = ~0u;
+    for (unsigned char c: text) {
+        crc ^= c;
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void put32(std::string &out, uint32_t x) {
+    for (int k = 0; k < 4; ++k) {
+        out += char(x >> (8 * k));
+    }
+}
+
+// gzip из stored-блоков (BTYPE = 0) по block байт
+std::string stored_gzip(std::string_view plain, size_t block = 65535) {
+    std::string out = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, 3};
+    size_t pos = 0;
+    do {
+        size_t n = std::min(block, plain.size() - pos);
+        out += char(pos + n == plain.size()); // BFINAL, BTYPE = 0, остаток байта — выравнивание
+        out += char(n);
+        out += char(n >> 8);
+        out += char(~n);
+        out += char(~n >> 8);
+        out.append(plain.substr(pos, n));
+        pos += n;
+    } while (pos < plain.size());
+    put32(out, crc32(plain));
+    put32(out, plain.size());
+    return out;
+}
+
+bool decode(std::string_view data, std::string &text, std::string &error) {
+    text.clear();
+    return gunzip(data, [&](std::string_view part) {
+        text.append(part);
+        return true;
+    }, error);
+}
+
+std::string decode_ok(std::string_view data) {
+    std::string text, error;
+    EXPECT_TRUE(decode(data, text, error)) << error;
+    return text;
+}
+
+} // namespace
+
+
+TEST(GzipTest, Signature) {
+    ASSERT_TRUE(is_gzip(bytes(kFixed, sizeof(kFixed))));
+    ASSERT_FALSE(is_gzip("plain text"));
+    ASSERT_FALSE(is_gzip("\x1f"));
+}
+
+TEST(GzipTest, StoredBlocks) {
+    ASSERT_EQ(decode_ok(stored_gzip("")), "");
+    ASSERT_EQ(decode_ok(stored_gzip("one stored block\n")), "one stored block\n");
+    // несколько блоков и вывод больше одного куска sink (~1 МБ)
+    std::string plain;
+    for (int i = 0; plain.size() < (3 << 20); ++i) {
+        plain += "line " + std::to_string(i * 7919) + "\n";
+    }
+    ASSERT_EQ(decode_ok(stored_gzip(plain, 1000)), plain);
+    ASSERT_EQ(decode_ok(stored_gzip(plain)), plain);
+}
+
+TEST(GzipTest, FixedHuffman) {
+    ASSERT_EQ(decode_ok(bytes(kFixed, sizeof(kFixed))), fixed_plain());
+}
+
+TEST(GzipTest, DynamicHuffman) {
+    ASSERT_EQ(decode_ok(bytes(kDynamic, sizeof(kDynamic))), dynamic_plain());
+}
+
+TEST(GzipTest, ConcatenatedMembers) {
+    std::string data = bytes(kFixed, sizeof(kFixed)) + stored_gzip("stored\n") + bytes(kDynamic, sizeof(kDynamic)) +
+                       bytes(kFixed, sizeof(kFixed));
+    ASSERT_EQ(decode_ok(data), fixed_plain() + "stored\n" + dynamic_plain() + fixed_plain());
+}
+
+TEST(GzipTest, SinkStops) {
+    std::string error;
+    int calls = 0;
+    ASSERT_TRUE(gunzip(bytes(kDynamic, sizeof(kDynamic)), [&](std::string_view) {
+        calls++;
+        return false;
+    }, error));
+    ASSERT_EQ(calls, 1);
+}
+
+TEST(GzipTest, RejectsTruncated) {
+    for (std::string full: {bytes(kFixed, sizeof(kFixed)), bytes(kDynamic, sizeof(kDynamic)), stored_gzip("stored\n")}) {
+        for (size_t n = 0; n < full.size(); ++n) {
+            std::string text, error;
+            ASSERT_FALSE(decode(std::string_view(full).substr(0, n), text, error)) << n << " of " << full.size();
+            ASSERT_FALSE(error.empty());
+        }
+    }
+    // обрезан второй поток
+    std::string text, error;
+    std::string two = bytes(kFixed, sizeof(kFixed)) + bytes(kDynamic, sizeof(kDynamic));
+    ASSERT_FALSE(decode(std::string_view(two).substr(0, two.size() - 5), text, error));
+}
+
+TEST(GzipTest, RejectsCrcAndSizeMismatch) {
+    std::string good = bytes(kDynamic, sizeof(kDynamic));
+    for (size_t k: {good.size() - 8, good.size() - 5, good.size() - 4, good.size() - 1}) {
+        std::string bad = good;
+        bad[k] ^= 1; // k < size - 4 — CRC32, дальше — ISIZE
+        std::string text, error;
+        ASSERT_FALSE(decode(bad, text, error)) << k;
+        ASSERT_EQ(error, "gzip crc mismatch");
+    }
+    // испорчены сами данные stored-блока: структура цела, не сходится CRC32
+    std::string stored = stored_gzip("stored data\n");
+    stored[16] ^= 0x20;
+    std::string text, error;
+    ASSERT_FALSE(decode(stored, text, error));
+    ASSERT_EQ(error, "gzip crc mismatch");
+}
+
+TEST(GzipTest, RejectsBadHeaderAndBlockType) {
+    std::string text, error;
+    ASSERT_FALSE(decode("not gzip at all", text, error));
+    ASSERT_EQ(error, "not a gzip file");
+
+    std::string bad = bytes(kFixed, sizeof(kFixed));
+    bad[10] |= 0x06; // BTYPE = 3
+    ASSERT_FALSE(decode(bad, text, error));
+    ASSERT_EQ(error, "bad block type");
+
+    // LEN и NLEN stored-блока не совпадают
+    std::string stored = stored_gzip("stored\n");
+    stored[13] ^= 1;
+    ASSERT_FALSE(decode(stored, text, error));
+}
@@ -0,0 +1,150 @@
+#include <lib/log_index.h>
+#include <lib/mapped_file.h>
+#include <lib/parser.h>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+
+namespace {
+
+// -s/-w/--histogram по тексту (--no-index) и по индексу дают одно и то же
+void expect_same_report(const std::string &options, const std::string &log_path, const TempDir &dir) {
+    CliResult text = run_analyzelog(options + " --no-index " + log_path, dir);
+    CliResult indexed = run_analyzelog(options + " " + log_path, dir);
+    ASSERT_EQ(text.status, 0) << options;
+    ASSERT_EQ(indexed.status, 0) << options;
+    ASSERT_EQ(indexed.err, "") << options; // индекс не отброшен
+    ASSERT_FALSE(text.out.empty()) << options;
+    ASSERT_EQ(indexed.out, text.out) << options;
+}
+
+void flip_byte(const std::string &path, size_t offset) {
+    std::string data = read_file(path);
+    ASSERT_LT(offset, data.size());
+    data[offset] ^= 1;
+    write_file(path, data);
+}
+
+} // namespace
+
+
+TEST(LogIndexTest, ColumnsMatchParsedLines) {
+    TempDir dir;
+    std::string log_path = dir.file("access.log"), idx = index_path_for(log_path.c_str());
+    write_file(log_path, test_log(3000, 9));
+    std::string error;
+    uint64_t rows = 0;
+    ASSERT_TRUE(build_index(log_path.c_str(), idx.c_str(), error, &rows)) << error;
+
+    LogIndex index(idx.c_str());
+    ASSERT_TRUE(index.is_open());
+    std::string reason;
+    ASSERT_TRUE(index.fresh_for(log_path.c_str(), reason)) << reason;
+    ASSERT_EQ(index.rows(), rows);
+    ASSERT_GT(rows, 2800u); // неразборчивых строк около 2%
+
+    MappedFile in(log_path.c_str());
+    LineReader reader(in.view());
+    std::string_view line;
+    uint64_t i = 0;
+    while (reader.next(line)) {
+        log cur = parse_log(line);
+        if (cur.status == -9) {
+            continue;
+        }
+        ASSERT_LT(i, index.rows());
+        ASSERT_EQ(index.times()[i], cur.time) << i;
+        ASSERT_EQ(index.statuses()[i], cur.status) << i;
+        ASSERT_EQ(index.request(index.requests()[i]), cur.request) << i;
+        ASSERT_EQ(index.host(index.hosts()[i]), cur.anlog) << i;
+        i++;
+    }
+    ASSERT_EQ(i, index.rows());
+}
+
+TEST(LogIndexTest, ReportsMatchTextScan) {
+    TempDir dir;
+    std::string log_path = dir.file("access.log");
+    write_file(log_path, test_log(5000, 11, 804556800, 7200, 40));
+    ASSERT_EQ(run_analyzelog("index " + log_path, dir).status, 0);
+
+    expect_same_report("-s 7", log_path, dir);
+    expect_same_report("-w 1,60,600", log_path, dir);
+    expect_same_report("-s 3 -w 300 --histogram=min,3", log_path, dir);
+    expect_same_report("--approx=0.01 -s 5", log_path, dir);
+    expect_same_report("-s 5 -w 60 --from=804558000 --to=804560000", log_path, dir);
+}
+
+TEST(LogIndexTest, RejectsStaleIndex) {
+    TempDir dir;
+    std::string log_path = dir.file("access.log"), idx = index_path_for(log_path.c_str());
+    std::string text = test_log(500, 3);
+    write_file(log_path, text);
+    std::string error;
+    ASSERT_TRUE(build_index(log_path.c_str(), idx.c_str(), error)) << error;
+
+    // дописанная строка
+    write_file(log_path, text + "h - - [01/Jul/1995:00:00:01 -0400] \"GET /new HTTP/1.0\" 500 1\n");
+    std::string reason;
+    ASSERT_FALSE(LogIndex(idx.c_str()).fresh_for(log_path.c_str(), reason));
+    ASSERT_EQ(reason, "log changed after indexing");
+    CliResult result = run_analyzelog("-s 3 " + log_path, dir);
+    ASSERT_EQ(result.status, 0);
+    ASSERT_NE(result.err.find("ignored: log changed after indexing"), std::string::npos) << result.err;
+    ASSERT_EQ(result.out, run_analyzelog("-s 3 --no-index " + log_path, dir).out);
+
+    // тот же размер, другое содержимое и время изменения
+    ASSERT_TRUE(build_index(log_path.c_str(), idx.c_str(), error)) << error;
+    ASSERT_TRUE(LogIndex(idx.c_str()).fresh_for(log_path.c_str(), reason)) << reason;
+    std::string same_size = read_file(log_path);
+    same_size[same_size.find("/new")] = '_';
+    write_file(log_path, same_size);
+    ASSERT_FALSE(LogIndex(idx.c_str()).fresh_for(log_path.c_str(), reason));
+    ASSERT_EQ(reason, "log changed after indexing");
+
+    ASSERT_FALSE(LogIndex(idx.c_str()).fresh_for(dir.file("missing.log").c_str(), reason));
+}
+
+TEST(LogIndexTest, RejectsCorruptIndex) {
+    TempDir dir;
+    std::string log_path = dir.file("access.log"), idx = index_path_for(log_path.c_str());
+    write_file(log_path, test_log(500, 5));
+    std::string error;
+    ASSERT_TRUE(build_index(log_path.c_str(), idx.c_str(), error)) << error;
+    std::string good = read_file(idx);
+
+    struct Damage {
+        size_t offset;
+        const char *reason; // что скажет fresh_for, если заголовок вообще узнан
+    };
+    // магия, версия, смещение секции, строки в словаре и столбец времени
+    Damage damages[] = {
+        {0, "not an index"},
+        {offsetof(LogIndexHeader, version), "version 0, expected 1"},
+        {offsetof(LogIndexHeader, time_offset), "damaged layout"},
+        {good.size() - 3, "checksum mismatch"},
+        {sizeof(LogIndexHeader) + 1, "checksum mismatch"},
+    };
+    for (const Damage &damage: damages) {
+        write_file(idx, good);
+        flip_byte(idx, damage.offset);
+        std::string reason;
+        LogIndex index(idx.c_str());
+        ASSERT_FALSE(index.is_open() && index.fresh_for(log_path.c_str(), reason)) << damage.offset;
+        if (index.is_open()) {
+            ASSERT_EQ(reason, damage.reason) << damage.offset;
+        }
+        CliResult result = run_analyzelog("-s 3 " + log_path, dir);
+        ASSERT_EQ(result.out, run_analyzelog("-s 3 --no-index " + log_path, dir).out) << damage.offset;
+    }
+
+    // обрезанный файл
+    write_file(idx, good.substr(0, good.size() / 2));
+    std::string reason;
+    LogIndex index(idx.c_str());
+    ASSERT_FALSE(index.is_open() && index.fresh_for(log_path.c_str(), reason));
+}
@@ -0,0 +1,127 @@
+#include <lib/load_profile.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+// прежний плотный профиль: массив всех интервалов от первого до последнего
+struct DenseProfile {
+    long long step = 1;
+    long long first = 0;
+    std::vector<uint64_t> counts;
+
+    DenseProfile(const TimeHistogram &hist, int granularity) : step(granularity) {
+        std::vector<std::pair<int, uint32_t>> seconds = hist.entries();
+        long long lo = seconds.front().first / step, hi = seconds.back().first / step;
+        first = lo * step;
+        counts.assign(hi - lo + 1, 0);
+        for (const auto &[time, count]: seconds) {
+            counts[time / step - lo] += count;
+        }
+    }
+
+    uint64_t sum(size_t i, size_t j) const {
+        uint64_t s = 0;
+        for (size_t t = i; t < j; ++t) {
+            s += counts[t];
+        }
+        return s;
+    }
+
+    uint64_t percentile(double p) const {
+        std::vector<uint64_t> sorted = counts;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = (size_t) std::ceil(p / 100 * sorted.size());
+        return sorted[rank == 0 ? 0 : rank - 1];
+    }
+
+    std::vector<LoadProfile::Window> busiest(size_t length, size_t k) const {
+        std::vector<LoadProfile::Window> result;
+        length = std::min(length, counts.size());
+        std::vector<size_t> order;
+        for (size_t i = 0; i + length <= counts.size(); ++i) {
+            order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return sum(a, a + length) > sum(b, b + length); });
+        std::vector<char> taken(counts.size(), 0);
+        for (size_t i: order) {
+            if (result.size() == k || sum(i, i + length) == 0) {
+                break;
+            }
+            if (taken[i] || taken[i + length - 1]) {
+                continue;
+            }
+            std::fill(taken.begin() + i, taken.begin() + i + length, 1);
+            result.push_back({first + (long long) i * step, sum(i, i + length)});
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+
+TEST(LoadProfileTest, FarOutlierDoesNotAllocateSpan) {
+    // 1995 и 2030 годы: плотный массив по секундам занял бы ~8.8 ГБ
+    TimeHistogram hist;
+    hist.add(788918400);
+    hist.add(788918400);
+    hist.add(1893456000);
+    LoadProfile profile(hist, 1);
+    ASSERT_EQ(profile.size(), size_t(1893456000 - 788918400 + 1));
+    ASSERT_EQ(profile.start(), 788918400);
+    ASSERT_EQ(profile.at(0), 2u);
+    ASSERT_EQ(profile.at(profile.size() - 1), 1u);
+    ASSERT_EQ(profile.sum(1, profile.size() - 1), 0u);
+
+    LoadProfile::Window peak = profile.peak();
+    ASSERT_EQ(peak.begin, 788918400);
+    ASSERT_EQ(peak.count, 2u);
+    ASSERT_EQ(profile.percentile(50), 0u);
+    ASSERT_EQ(profile.percentile(100), 2u);
+
+    std::vector<LoadProfile::Window> top = profile.busiest(60, 10);
+    ASSERT_EQ(top.size(), 2u);
+    ASSERT_EQ(top[0].begin, 788918400);
+    ASSERT_EQ(top[0].count, 2u);
+    ASSERT_EQ(top[1].begin, 1893456000 - 59);
+    ASSERT_EQ(top[1].count, 1u);
+}
+
+TEST(LoadProfileTest, MatchesDenseProfile) {
+    uint64_t state = 239;
+    auto next = [&]() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    };
+    for (int round = 0; round < 200; ++round) {
+        TimeHistogram hist;
+        int base = 1000000 + next() % 1000, span = 1 + next() % 300, lines = 1 + next() % 40;
+        for (int i = 0; i < lines; ++i) {
+            hist.add(base + next() % span, 1 + next() % 3);
+        }
+        int step = 1 + next() % 7;
+        LoadProfile profile(hist, step);
+        DenseProfile dense(hist, step);
+        ASSERT_EQ(profile.start(), dense.first);
+        ASSERT_EQ(profile.size(), dense.counts.size());
+        for (size_t i = 0; i < dense.counts.size(); ++i) {
+            ASSERT_EQ(profile.at(i), dense.counts[i]);
+        }
+        for (double p: {0.0, 25.0, 50.0, 95.0, 99.0, 100.0}) {
+            ASSERT_EQ(profile.percentile(p), dense.percentile(p)) << p;
+        }
+        for (size_t length: {1, 2, 5, 13, 1000}) {
+            std::vector<LoadProfile::Window> got = profile.busiest(length, 5), want = dense.busiest(length, 5);
+            ASSERT_EQ(got.size(), want.size()) << round << ' ' << length;
+            for (size_t i = 0; i < got.size(); ++i) {
+                ASSERT_EQ(got[i].begin, want[i].begin) << round << ' ' << length << ' ' << i;
+                ASSERT_EQ(got[i].count, want[i].count) << round << ' ' << length << ' ' << i;
+            }
+        }
+    }
+}
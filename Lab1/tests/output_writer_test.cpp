@@ -0,0 +1,112 @@
+#include <lib/output_writer.h>
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "test_util.h"
+
+
+namespace {
+
+// строка из n символов без '\n'
+std::string filler(size_t n, char c) {
+    return std::string(n, c);
+}
+
+} // namespace
+
+
+TEST(OutputWriterTest, FailedOpen) {
+    TempDir dir;
+    OutputWriter writer;
+    ASSERT_FALSE(writer.open_file(dir.file("missing/out.txt").c_str()));
+    ASSERT_FALSE(writer.ok());
+    ASSERT_EQ(writer.error(), ENOENT);
+    writer.add("line");
+    ASSERT_FALSE(writer.flush());
+}
+
+TEST(OutputWriterTest, FailedWrite) {
+    if (access("/dev/full", W_OK) != 0) {
+        GTEST_SKIP() << "no /dev/full";
+    }
+    for (size_t size: {size_t(10), OutputWriter::kBufferSize * 3}) {
+        OutputWriter writer;
+        ASSERT_TRUE(writer.open_file("/dev/full"));
+        ASSERT_TRUE(writer.ok());
+        writer.add("first line");
+        writer.add_block(filler(size, 'x') + "\n");
+        ASSERT_FALSE(writer.flush()) << size;
+        ASSERT_FALSE(writer.ok());
+        ASSERT_EQ(writer.error(), ENOSPC);
+        // ошибка не сбрасывается следующими записями
+        writer.add("more");
+        ASSERT_FALSE(writer.flush());
+        ASSERT_EQ(writer.error(), ENOSPC);
+    }
+}
+
+// строки и куски больше буфера уходят вторым элементом writev; в оба приёмника одни и те же байты
+TEST(OutputWriterTest, BytesMatchInput) {
+    TempDir dir;
+    std::string first = dir.file("first.txt"), second = dir.file("second.txt");
+    std::string want;
+    int fd = open(second.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    ASSERT_GE(fd, 0);
+    {
+        OutputWriter writer;
+        ASSERT_TRUE(writer.open_file(first.c_str()));
+        writer.add_fd(fd);
+        auto line = [&](const std::string &text) {
+            writer.add(text);
+            want += text + "\n";
+        };
+        auto block = [&](const std::string &text) {
+            writer.add_block(text);
+            want += text;
+        };
+        uint64_t state = 9;
+        for (int i = 0; i < 2000; ++i) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            line("line " + std::to_string(i) + filler((state >> 33) % 2000, 'a' + i % 26));
+        }
+        block(filler(OutputWriter::kBufferSize + 123, 'b') + "\n");      // не влезает в буфер
+        line("after block");
+        block("small\nblock\n");
+        line(filler(OutputWriter::kBufferSize * 2, 'c'));                // строка длиннее буфера
+        line(filler(OutputWriter::kBufferSize - 1, 'd'));                // ровно на весь буфер с '\n'
+        line("");
+        block(filler(OutputWriter::kBufferSize - 5, 'e') + "\n");
+        ASSERT_TRUE(writer.flush());
+        ASSERT_TRUE(writer.ok());
+        ASSERT_EQ(writer.error(), 0);
+        line("tail, flushed by the destructor");
+    }
+    // чужой дескриптор деструктор не закрывает
+    ASSERT_EQ(close(fd), 0);
+    ASSERT_EQ(read_file(first), want);
+    ASSERT_EQ(read_file(second), want);
+}
+
+// ErrorWriter в AnalyzeLog: код возврата и причина в stderr
+TEST(OutputWriterTest, CliReportsFailures) {
+    TempDir dir;
+    std::string log_path = dir.file("access.log");
+    write_file(log_path, test_log(500, 7));
+    CliResult missing = run_analyzelog("-o " + dir.file("missing/out.txt") + " " + log_path, dir);
+    ASSERT_EQ(missing.status, 1);
+    ASSERT_NE(missing.err.find("cannot open"), std::string::npos) << missing.err;
+    if (access("/dev/full", W_OK) == 0) {
+        CliResult full = run_analyzelog("-o /dev/full " + log_path, dir);
+        ASSERT_EQ(full.status, 1);
+        ASSERT_NE(full.err.find("cannot write 5xx lines"), std::string::npos) << full.err;
+    }
+    CliResult good = run_analyzelog("-o " + dir.file("out.txt") + " " + log_path, dir);
+    ASSERT_EQ(good.status, 0);
+    ASSERT_EQ(good.err, "");
+    ASSERT_NE(read_file(dir.file("out.txt")), "");
+}
@@ -0,0 +1,217 @@
+#include <lib/mapped_file.h>
+#include <lib/parser.h>
+#include <gtest/gtest.h>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+
+namespace {
+
+std::vector<TokenizerKind> kinds() {
+    std::vector<TokenizerKind> result = {TokenizerKind::Scalar};
+#if defined(__SSE2__) || defined(_M_X64)
+    result.push_back(TokenizerKind::Sse2);
+#endif
+    if (best_tokenizer() == TokenizerKind::Avx2) {
+        result.push_back(TokenizerKind::Avx2);
+    }
+    return result;
+}
+
+// разбор поиском, как в прежнем parse_log: первый пробел, '[' после него, ']' после неё,
+// первая кавычка после ']', последняя кавычка строки и число сразу за ней
+bool reference_tokenize(std::string_view line, ClfFields &out) {
+    size_t host = line.find(' ');
+    size_t open = line.find('[', host == std::string_view::npos ? host : host + 1);
+    size_t close = line.find(']', open == std::string_view::npos ? open : open + 1);
+    size_t q1 = line.find('"', close == std::string_view::npos ? close : close + 1);
+    if (host == std::string_view::npos || open == std::string_view::npos || close == std::string_view::npos ||
+        q1 == std::string_view::npos) {
+        return false;
+    }
+    size_t q2 = line.rfind('"');
+    if (q2 == q1) {
+        return false;
+    }
+    size_t s = line.find_first_not_of(' ', q2 + 1);
+    s = s == std::string_view::npos ? line.size() : s;
+    size_t e = s;
+    while (e < line.size() && line[e] >= '0' && line[e] <= '9') {
+        e++;
+    }
+    if (e == s) {
+        return false;
+    }
+    out.host = line.substr(0, host);
+    out.timestamp = line.substr(open + 1, close - open - 1);
+    out.request = line.substr(q1 + 1, q2 - q1 - 1);
+    out.status = line.substr(s, e - s);
+    return true;
+}
+
+// все варианты tokenize_clf и parse_log дают то же, что reference_tokenize
+void check_line(std::string_view line) {
+    ClfFields want;
+    bool ok = reference_tokenize(line, want);
+    for (TokenizerKind kind: kinds()) {
+        ClfFields got;
+        ASSERT_EQ(tokenize_clf(line, got, kind), ok) << tokenizer_name(kind) << ": " << line;
+        if (ok) {
+            ASSERT_EQ(got.host, want.host) << tokenizer_name(kind) << ": " << line;
+            ASSERT_EQ(got.timestamp, want.timestamp) << tokenizer_name(kind) << ": " << line;
+            ASSERT_EQ(got.request, want.request) << tokenizer_name(kind) << ": " << line;
+            ASSERT_EQ(got.status, want.status) << tokenizer_name(kind) << ": " << line;
+        }
+    }
+    int time = 0, status = 0;
+    ok = ok && parse_clf_time(want.timestamp, time) &&
+         std::from_chars(want.status.data(), want.status.data() + want.status.size(), status).ec == std::errc();
+    log parsed = parse_log(line);
+    ASSERT_EQ(parsed.status, ok ? status : -9) << line;
+    if (ok) {
+        ASSERT_EQ(parsed.time, time) << line;
+        ASSERT_EQ(parsed.request, want.request) << line;
+        ASSERT_EQ(parsed.anlog, want.host) << line;
+    }
+}
+
+const char *kLine = "199.72.81.55 - - [01/Jul/1995:00:00:01 -0400] \"GET /history/apollo/ HTTP/1.0\" 200 6245";
+
+} // namespace
+
+
+TEST(ParserTest, KnownLine) {
+    log parsed = parse_log(kLine);
+    ASSERT_EQ(parsed.status, 200);
+    ASSERT_EQ(parsed.time, 804571201);
+    ASSERT_EQ(parsed.request, "GET /history/apollo/ HTTP/1.0");
+    ASSERT_EQ(parsed.anlog, "199.72.81.55");
+    check_line(kLine);
+}
+
+TEST(ParserTest, TimeZones) {
+    int time = 0;
+    ASSERT_TRUE(parse_clf_time("01/Jul/1995:00:00:01 -0400", time));
+    ASSERT_EQ(time, 804571201);
+    ASSERT_TRUE(parse_clf_time("01/Jul/1995:00:00:01 +0000", time));
+    ASSERT_EQ(time, 804556801);
+    ASSERT_TRUE(parse_clf_time("01/Jul/1995:00:00:01", time));
+    ASSERT_EQ(time, 804556801);
+    ASSERT_TRUE(parse_clf_time("29/Feb/2024:23:59:59 +0530", time));
+    ASSERT_EQ(time, 1709231399);
+    ASSERT_FALSE(parse_clf_time("1/Jul/1995:00:00:01 -0400", time));
+    ASSERT_FALSE(parse_clf_time("01/Jux/1995:00:00:01 -0400", time));
+    ASSERT_FALSE(parse_clf_time("01/Jul/1995:00:00:01 -04x0", time));
+
+    for (const char *zone: {"+0000", "+0530", "-1200", "+1400"}) {
+        check_line(std::string("h - - [29/Feb/2024:23:59:59 ") + zone + "] \"GET /x HTTP/1.0\" 500 1");
+    }
+}
+
+TEST(ParserTest, OddLines) {
+    const char *lines[] = {
+        // время не из 27 символов: без зоны, короткий день, лишнее перед ']'
+        "h - - [01/Jul/1995:00:00:01] \"GET /a HTTP/1.0\" 200 1",
+        "host.example.com - - [1/Jul/1995:00:00:01 -0400] \"GET /a HTTP/1.0\" 200 1",
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400 extra] \"GET /a HTTP/1.0\" 200 1",
+        "host.example.com - - [01/Jul/1995:00:00:01 -04] \"GET /some/long/path/to/file.html HTTP/1.0\" 200 1",
+        // нет закрывающей кавычки и вообще кавычек
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /some/long/path/to/file.html HTTP/1.0 200 1",
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] GET /some/long/path/to/file.html HTTP/1.0 200 1",
+        // кавычки внутри запроса
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /a\"b\" HTTP/1.0\" 404 -",
+        // статус: нет, не число, пробелы, цифры и буквы, слишком большой
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /some/long/path/to/file.html HTTP/1.0\"",
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /some/long/path/to/file.html HTTP/1.0\" abc 1",
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /some/long/path/to/file.html HTTP/1.0\" - 1",
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /some/long/path/to/file.html HTTP/1.0\"    503",
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /some/long/path/to/file.html HTTP/1.0\" 20x 1",
+        "host.example.com - - [01/Jul/1995:00:00:01 -0400] \"GET /some/long/path/to/file.html HTTP/1.0\" 99999999999",
+        // нет структуры
+        "",
+        "h",
+        "no brackets \"GET /\" 200 1",
+        "h - - [01/Jul/1995:00:00:01 -0400 \"GET /\" 200 1",
+        "[01/Jul/1995:00:00:01 -0400] \"GET /\" 200 1",
+        "h - - ] [01/Jul/1995:00:00:01 -0400] \"GET /\" 200 1",
+    };
+    for (const char *line: lines) {
+        check_line(line);
+    }
+}
+
+// все длины вокруг границ блоков 16/32 и быстрого пути от 64 байт
+TEST(ParserTest, LineLengths) {
+    for (int n = 0; n < 200; ++n) {
+        std::string line = "h - - [01/Jul/1995:00:00:01 -0400] \"GET /" + std::string(n, 'a') + "\" 200 1";
+        check_line(line);
+        check_line(line.substr(0, line.size() - 6)); // обрезано на разных местах
+        check_line(std::string(n, 'x') + " - - [01/Jul/1995:00:00:01 +0100] \"G\" 302 0");
+    }
+}
+
+// случайные строки и настоящая строка с несколькими заменёнными, вставленными или удалёнными символами
+TEST(ParserTest, RandomLines) {
+    const char alphabet[] = "  [[]]\"\"0123456789aZ/:-+";
+    uint64_t state = 4;
+    auto next = [&state](uint64_t n) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return (state >> 33) % n;
+    };
+    for (int t = 0; t < 200000; ++t) {
+        std::string line;
+        if (t % 2 == 0) {
+            for (size_t length = next(120); line.size() < length;) {
+                line += alphabet[next(sizeof(alphabet) - 1)];
+            }
+        } else {
+            line = kLine;
+            for (int edits = 1 + next(3); edits > 0; --edits) {
+                size_t at = next(line.size());
+                char c = alphabet[next(sizeof(alphabet) - 1)];
+                switch (next(3)) {
+                    case 0:
+                        line[at] = c;
+                        break;
+                    case 1:
+                        line.insert(line.begin() + at, c);
+                        break;
+                    default:
+                        line.erase(at, 1);
+                }
+            }
+        }
+        check_line(line);
+    }
+}
+
+// последняя строка кончается ровно на границе страницы, за ней отображения нет
+TEST(ParserTest, LineAtEndOfMapping) {
+    long page = sysconf(_SC_PAGESIZE);
+    for (size_t length: {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100}) {
+        std::string last = kLine;
+        last = length <= last.size() ? last.substr(last.size() - length) : std::string(length - last.size(), 'h') + last;
+        std::string text(2 * page - last.size(), '-');
+        text[text.size() - 1] = '\n';
+        text += last;
+        char path[] = "/tmp/parser_test_XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(write(fd, text.data(), text.size()), ssize_t(text.size()));
+        close(fd);
+        {
+            MappedFile in(path);
+            ASSERT_TRUE(in.is_open());
+            ASSERT_EQ(in.size(), size_t(2 * page));
+            std::string_view view = in.view();
+            check_line(view.substr(view.size() - last.size()));
+        }
+        unlink(path);
+    }
+}
@@ -0,0 +1,102 @@
+#include <lib/request_counter.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+uint64_t next(uint64_t &state, uint64_t n) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return (state >> 33) % n;
+}
+
+using Top = std::vector<std::pair<std::string_view, uint64_t>>;
+
+// k лучших по эталонному std::map: по убыванию счётчика, при равенстве по алфавиту
+Top reference_top(const std::map<std::string, uint64_t> &counts, size_t k) {
+    Top all(counts.begin(), counts.end());
+    std::stable_sort(all.begin(), all.end(), [](const auto &a, const auto &b) { return a.second > b.second; });
+    all.resize(std::min(k, all.size()));
+    return all;
+}
+
+} // namespace
+
+
+// много различных запросов (таблица растёт несколько раз), малые счётчики — много равенств
+TEST(RequestCounterTest, MatchesMap) {
+    uint64_t state = 17;
+    RequestCounter counter;
+    std::map<std::string, uint64_t> reference;
+    for (int i = 0; i < 200000; ++i) {
+        // запросы разной длины, в том числе с общим префиксом и пустой
+        std::string request = next(state, 100) == 0 ? "" : "GET /" + std::to_string(next(state, 40000)) + "/index.html";
+        uint64_t count = next(state, 10) == 0 ? 1 + next(state, 5) : 1;
+        counter.add(request, count);
+        reference[request] += count;
+    }
+    ASSERT_EQ(counter.size(), reference.size());
+    // все счётчики сразу: top по всем запросам
+    ASSERT_EQ(counter.top(counter.size() + 10), reference_top(reference, reference.size()));
+    for (size_t k: {0, 1, 2, 10, 1000}) {
+        ASSERT_EQ(counter.top(k), reference_top(reference, k)) << k;
+    }
+}
+
+// при равных счётчиках порядок по алфавиту, а не по порядку добавления или хешу
+TEST(RequestCounterTest, TiesBreakAlphabetically) {
+    RequestCounter counter;
+    for (const char *request: {"GET /d", "GET /b", "GET /c", "GET /a", "GET /e"}) {
+        counter.add(request, 2);
+    }
+    counter.add("GET /z", 3);
+    Top want = {{"GET /z", 3}, {"GET /a", 2}, {"GET /b", 2}, {"GET /c", 2}};
+    ASSERT_EQ(counter.top(4), want);
+}
+
+// merge двух счётчиков — то же, что добавить всё в один
+TEST(RequestCounterTest, MergeMatchesMap) {
+    uint64_t state = 23;
+    RequestCounter left, right;
+    std::map<std::string, uint64_t> reference;
+    for (int i = 0; i < 50000; ++i) {
+        std::string request = "GET /page" + std::to_string(next(state, 5000));
+        (next(state, 2) ? left : right).add(request);
+        reference[request]++;
+    }
+    left.merge(right);
+    ASSERT_EQ(left.size(), reference.size());
+    ASSERT_EQ(left.top(reference.size()), reference_top(reference, reference.size()));
+}
+
+
+// top(k, previous, fresh) между отчётами --follow совпадает с полным top(k)
+TEST(RequestCounterTest, IncrementalTopMatchesFull) {
+    uint64_t state = 5;
+    for (size_t k: {1, 3, 10}) {
+        RequestCounter total;
+        std::vector<std::string> leaders;
+        for (int tick = 0; tick < 200; ++tick) {
+            RequestCounter fresh;
+            // много запросов с малыми счётчиками, чтобы часто были равенства и смена лидеров
+            size_t adds = next(state, 40);
+            for (size_t i = 0; i < adds; ++i) {
+                std::string request = "GET /page" + std::to_string(next(state, 1 + tick)) + ".html";
+                uint64_t count = 1 + next(state, 3);
+                fresh.add(request, count);
+                total.add(request, count);
+            }
+            std::vector<std::pair<std::string_view, uint64_t>> want = total.top(k);
+            std::vector<std::pair<std::string_view, uint64_t>> got = total.top(k, leaders, fresh);
+            ASSERT_EQ(got, want) << k << ' ' << tick;
+            leaders.clear();
+            for (const auto &[request, count]: got) {
+                leaders.emplace_back(request);
+            }
+        }
+    }
+}
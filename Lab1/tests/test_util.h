@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+
+// Общее для тестов, которые работают с файлами и запускают собранный AnalyzeLog.
+
+// каталог в /tmp, удаляется вместе со всем содержимым
+struct TempDir {
+    std::string path;
+
+    TempDir() {
+        char name[] = "/tmp/analyzelog_test_XXXXXX";
+        path = mkdtemp(name);
+    }
+
+    ~TempDir() {
+        std::filesystem::remove_all(path);
+    }
+
+    std::string file(const std::string &name) const {
+        return path + "/" + name;
+    }
+};
+
+inline void write_file(const std::string &path, const std::string &text) {
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+inline std::string read_file(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    return out.str();
+}
+
+struct CliResult {
+    int status = -1;
+    std::string out;
+    std::string err;
+};
+
+// AnalyzeLog с аргументами args (как в командной строке); stdout и stderr по отдельности
+inline CliResult run_analyzelog(const std::string &args, const TempDir &dir) {
+    std::string out_path = dir.file("stdout.txt"), err_path = dir.file("stderr.txt");
+    std::string command = std::string(ANALYZELOG_BIN) + " " + args + " >" + out_path + " 2>" + err_path;
+    CliResult result;
+    int status = std::system(command.c_str());
+    result.status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    result.out = read_file(out_path);
+    result.err = read_file(err_path);
+    return result;
+}
+
+// Синтетический CLF-лог: base + [0, spread) секунд, внутри каждых shuffle строк время перемешано,
+// примерно каждая десятая строка — 5xx, среди строк попадаются неразборчивые.
+inline std::string test_log(size_t lines, uint64_t seed, int base = 804556800, int spread = 86400, size_t shuffle = 1) {
+    static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    uint64_t state = seed;
+    auto next = [&state](uint64_t n) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return (state >> 33) % n;
+    };
+    std::string text;
+    for (size_t i = 0; i < lines; ++i) {
+        if (next(50) == 0) {
+            text += "garbage line without structure\n";
+            continue;
+        }
+        // время растёт с номером строки, но в пределах окна из shuffle строк идёт вразнобой
+        size_t slot = i / shuffle * shuffle + next(shuffle);
+        long long t = base + (long long) slot * spread / lines;
+        time_t tt = t - 4 * 3600; // в логе местное время -0400
+        struct tm parts;
+        gmtime_r(&tt, &parts);
+        char line[256];
+        int status = next(10) == 0 ? 500 + int(next(4)) : (next(3) == 0 ? 404 : 200);
+        snprintf(line, sizeof(line), "host%d.example.com - - [%02d/%s/%04d:%02d:%02d:%02d -0400] \"GET /page%d.html HTTP/1.0\" %d %d\n",
+                 int(next(40)), parts.tm_mday, months[parts.tm_mon], parts.tm_year + 1900, parts.tm_hour, parts.tm_min,
+                 parts.tm_sec, int(next(30)), status, int(next(100000)));
+        text += line;
+    }
+    return text;
+}
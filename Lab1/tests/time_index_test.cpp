@@ -0,0 +1,162 @@
+#include <lib/mapped_file.h>
+#include <lib/parser.h>
+#include <lib/time_index.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "test_util.h"
+
+
+namespace {
+
+struct Line {
+    size_t offset;
+    int time;
+    std::string_view text;
+};
+
+// разобранные строки лога в порядке файла
+std::vector<Line> parsed_lines(std::string_view text) {
+    std::vector<Line> result;
+    LineReader reader(text);
+    std::string_view line;
+    while (reader.next(line)) {
+        log cur = parse_log(line);
+        if (cur.status != -9) {
+            result.push_back({size_t(line.data() - text.data()), cur.time, line});
+        }
+    }
+    return result;
+}
+
+// строки со временем из [from, to], начинающиеся внутри кусков pieces
+std::vector<std::string_view> lines_in(const std::vector<Line> &lines, std::string_view text,
+                                       const std::vector<std::string_view> &pieces, long long from, long long to) {
+    std::vector<std::string_view> result;
+    for (std::string_view piece: pieces) {
+        size_t begin = piece.data() - text.data(), end = begin + piece.size();
+        // куски режутся только по началам строк
+        EXPECT_TRUE(begin == 0 || text[begin - 1] == '\n') << begin;
+        EXPECT_TRUE(end == text.size() || text[end - 1] == '\n') << end;
+        auto it = std::lower_bound(lines.begin(), lines.end(), begin,
+                                   [](const Line &line, size_t offset) { return line.offset < offset; });
+        for (; it != lines.end() && it->offset < end; ++it) {
+            if (it->time >= from && it->time <= to) {
+                result.push_back(it->text);
+            }
+        }
+    }
+    return result;
+}
+
+// лог на ~6 блоков по 64 КБ: время вразнобой внутри окон по 300 строк и несколько строк
+// из далёкого прошлого и будущего посреди файла, чтобы prefix-max/suffix-min были не монотонны по lo/hi
+std::string shuffled_log() {
+    std::string text = test_log(4500, 21, 804556800, 86400, 300);
+    const char *early = "early.example.com - - [30/Jun/1995:00:00:00 -0400] \"GET /early HTTP/1.0\" 200 1\n";
+    const char *late = "late.example.com - - [05/Jul/1995:00:00:00 -0400] \"GET /late HTTP/1.0\" 503 1\n";
+    for (size_t at: {size_t(150000), size_t(260000)}) {
+        size_t pos = text.find('\n', at) + 1;
+        text.insert(pos, at == 150000 ? late : early);
+    }
+    return text;
+}
+
+} // namespace
+
+
+TEST(TimeIndexTest, RangesMatchFullScan) {
+    TempDir dir;
+    std::string path = dir.file("access.log");
+    write_file(path, shuffled_log());
+    MappedFile in(path.c_str());
+    std::string_view text = in.view();
+    ASSERT_GT(text.size(), 5 * size_t(TimeIndex::kDefaultStep));
+
+    std::vector<Line> lines = parsed_lines(text);
+    TimeIndex index;
+    std::vector<int> block_lo, block_hi;
+    int min_time = INT_MAX, max_time = INT_MIN;
+    for (const Line &line: lines) {
+        size_t block = line.offset / TimeIndex::kDefaultStep;
+        index.add(line.offset, line.time);
+        block_lo.resize(std::max(block_lo.size(), block + 1), INT_MAX);
+        block_hi.resize(std::max(block_hi.size(), block + 1), INT_MIN);
+        block_lo[block] = std::min(block_lo[block], line.time);
+        block_hi[block] = std::max(block_hi[block], line.time);
+        min_time = std::min(min_time, line.time);
+        max_time = std::max(max_time, line.time);
+    }
+
+    // границы: времена на краях блоков и рядом, до первой и после последней строки
+    std::vector<long long> edges = {min_time - 100, min_time - 1, min_time, max_time, max_time + 1, max_time + 100};
+    for (size_t k = 0; k < block_lo.size(); ++k) {
+        for (long long t: {block_lo[k], block_hi[k]}) {
+            edges.push_back(t - 1);
+            edges.push_back(t);
+            edges.push_back(t + 1);
+        }
+    }
+    std::vector<std::string_view> all = {text};
+    size_t checked = 0;
+    for (long long from: edges) {
+        for (long long to: edges) {
+            std::vector<std::string_view> want = lines_in(lines, text, all, from, to);
+            std::vector<std::string_view> pieces = index.ranges(text, from, to);
+            ASSERT_EQ(lines_in(lines, text, pieces, from, to), want) << from << ' ' << to;
+            if (to < min_time || from > max_time || from > to) {
+                ASSERT_TRUE(want.empty());
+            }
+            checked += !want.empty();
+        }
+    }
+    ASSERT_GT(checked, 100u);
+
+    // после сохранения и загрузки то же самое
+    std::string tidx = time_index_path_for(path.c_str());
+    ASSERT_TRUE(index.save(tidx.c_str(), path.c_str(), text.size()));
+    TimeIndex loaded;
+    ASSERT_TRUE(loaded.load(tidx.c_str(), path.c_str()));
+    for (long long from: edges) {
+        ASSERT_EQ(lines_in(lines, text, loaded.ranges(text, from, max_time), from, max_time),
+                  lines_in(lines, text, all, from, max_time)) << from;
+    }
+}
+
+// --from/--to в AnalyzeLog: без .tidx, с только что собранным и с уже сохранённым — одинаково
+TEST(TimeIndexTest, CliMatchesFullScan) {
+    TempDir dir;
+    std::string path = dir.file("access.log");
+    write_file(path, shuffled_log());
+    std::string tidx = time_index_path_for(path.c_str());
+    const char *ranges[] = {
+        "--from=804600000 --to=804620000",
+        "--from=804556800 --to=804556800",
+        "--from=0 --to=804000000",          // до первой строки
+        "--from=805000000 --to=2000000000", // после последней
+        "--from=804484800 --to=804484800",  // строка из прошлого посреди файла
+        "--from=804916800 --to=804916800",  // строка из будущего
+    };
+    int non_empty = 0;
+    for (const char *range: ranges) {
+        std::string options = std::string(range) + " -s 5 -w 60 ";
+        std::filesystem::remove(tidx);
+        CliResult text = run_analyzelog(options + "--no-index -o " + dir.file("text.out") + " " + path, dir);
+        CliResult build = run_analyzelog(options + "-o " + dir.file("build.out") + " " + path, dir);
+        ASSERT_TRUE(std::filesystem::exists(tidx)) << range;
+        CliResult use = run_analyzelog(options + "-o " + dir.file("use.out") + " " + path, dir);
+        ASSERT_EQ(text.status, 0) << range;
+        ASSERT_EQ(build.out, text.out) << range;
+        ASSERT_EQ(use.out, text.out) << range;
+        ASSERT_EQ(use.err, "") << range;
+        std::string errors = read_file(dir.file("text.out"));
+        ASSERT_EQ(read_file(dir.file("build.out")), errors) << range;
+        ASSERT_EQ(read_file(dir.file("use.out")), errors) << range;
+        non_empty += !errors.empty();
+    }
+    ASSERT_GE(non_empty, 2);
+}
@@ -0,0 +1,146 @@
+#include <lib/histogram.h>
+#include <lib/window.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+uint64_t next(uint64_t &state, uint64_t n) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return (state >> 33) % n;
+}
+
+bool same(const std::vector<WindowSet::Result> &a, const std::vector<WindowSet::Result> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].t != b[i].t || a[i].count != b[i].count || a[i].l != b[i].l || a[i].r != b[i].r) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// окна заново по всей гистограмме, как в обычном запуске
+std::vector<WindowSet::Result> full(const std::vector<int> &lengths, const TimeHistogram &hist) {
+    WindowSet set(lengths);
+    for (const auto &[time, count]: hist.entries()) {
+        set.add(time, count);
+    }
+    return set.results();
+}
+
+// перебор: для каждой секунды r сумма по секундам из [r - t, r], побеждает первое окно с максимумом
+WindowSet::Result brute_force(const std::vector<std::pair<int, uint32_t>> &seconds, int t) {
+    WindowSet::Result best;
+    best.t = t;
+    for (size_t j = 0; j < seconds.size(); ++j) {
+        uint64_t sum = 0;
+        int l = seconds[j].first;
+        for (size_t i = j + 1; i-- > 0 && (long long) seconds[j].first - seconds[i].first <= t;) {
+            sum += seconds[i].second;
+            l = seconds[i].first;
+        }
+        if (sum > best.count) {
+            best.count = sum;
+            best.l = l;
+            best.r = seconds[j].first;
+        }
+    }
+    return best;
+}
+
+// редкие секунды с малыми счётчиками (много равных окон), пачки плотнее кольцевого буфера
+// и разрывы длиннее самого длинного окна
+std::vector<std::pair<int, uint32_t>> sparse_seconds(uint64_t seed, size_t n) {
+    uint64_t state = seed;
+    std::vector<std::pair<int, uint32_t>> seconds;
+    int time = 804556800;
+    for (size_t i = 0; i < n; ++i) {
+        switch (next(state, 4)) {
+        case 0:
+            time += 1;
+            break;
+        case 1:
+            time += 1 + next(state, 60);
+            break;
+        case 2:
+            time += 1 + next(state, 1000);
+            break;
+        default:
+            time += next(state, 20) == 0 ? 3601 + next(state, 10000) : 1 + next(state, 5);
+        }
+        seconds.emplace_back(time, 1 + next(state, 3));
+    }
+    return seconds;
+}
+
+} // namespace
+
+
+// несколько длин за один проход, самое длинное окно не первым — против перебора по каждой длине
+TEST(WindowTest, MatchesBruteForce) {
+    std::vector<std::vector<int>> sets = {{1}, {60}, {3600}, {60, 3600, 1}, {1, 1, 3600, 60}, {0, 5}};
+    for (uint64_t seed = 1; seed <= 20; ++seed) {
+        std::vector<std::pair<int, uint32_t>> seconds = sparse_seconds(seed, 3000);
+        for (const std::vector<int> &lengths: sets) {
+            WindowSet set(lengths);
+            for (const auto &[time, count]: seconds) {
+                set.add(time, count);
+            }
+            ASSERT_EQ(set.results().size(), lengths.size());
+            for (size_t i = 0; i < lengths.size(); ++i) {
+                WindowSet::Result want = brute_force(seconds, lengths[i]), got = set.results()[i];
+                ASSERT_EQ(got.t, want.t) << seed << ' ' << lengths[i];
+                ASSERT_EQ(got.count, want.count) << seed << ' ' << lengths[i];
+                ASSERT_EQ(got.l, want.l) << seed << ' ' << lengths[i];
+                ASSERT_EQ(got.r, want.r) << seed << ' ' << lengths[i];
+            }
+        }
+    }
+}
+
+// при равных суммах остаётся первое окно
+TEST(WindowTest, FirstOfEqualWindowsWins) {
+    WindowSet set({10, 100});
+    for (int time: {100, 105, 300, 305, 500, 600}) {
+        set.add(time, 1);
+    }
+    ASSERT_EQ(set.results()[0].l, 100);
+    ASSERT_EQ(set.results()[0].r, 105);
+    ASSERT_EQ(set.results()[0].count, 2u);
+    ASSERT_EQ(set.results()[1].l, 100);
+    ASSERT_EQ(set.results()[1].r, 105);
+    ASSERT_EQ(set.results()[1].count, 2u);
+}
+
+
+// LiveWindowSet между отчётами --follow совпадает с полным пересчётом: последняя секунда
+// дописывается после отчёта, изредка приходят секунды из прошлого
+TEST(WindowTest, LiveMatchesFullRecompute) {
+    std::vector<int> lengths = {1, 60, 3600};
+    uint64_t state = 11;
+    TimeHistogram all;
+    LiveWindowSet live(lengths);
+    int now = 804556800;
+    for (int tick = 0; tick < 300; ++tick) {
+        TimeHistogram fresh;
+        size_t lines = next(state, 20);
+        for (size_t i = 0; i < lines; ++i) {
+            int time = now;
+            if (next(state, 30) == 0) {
+                time -= next(state, 5000); // лог не по порядку
+            } else if (next(state, 3) == 0) {
+                now += next(state, 120);
+                time = now;
+            }
+            fresh.add(time);
+            all.add(time);
+        }
+        ASSERT_TRUE(same(live.update(fresh, all), full(lengths, all))) << tick;
+    }
+}
@@ -0,0 +1,83 @@
+// Микробенчмарк разбора ITMO Endian: побитовый разбор против unpack_itmo/pack_itmo (portable/bmi2).
+// codec_bench [numbers], по умолчанию 1M чисел по кругу 8 раз; каждый вариант работает со своей копией,
+// поэтому контрольные суммы должны совпасть.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../lib/itmo_endian.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// как было в number.cpp до кодека: сдвиг и нагрузка по одному биту
+void unpack_bitwise(const uint8_t* data, uint239_limbs& payload, uint64_t& shift) {
+    payload = uint239_limbs{{0, 0, 0, 0}};
+    shift = 0;
+    for (int i = 0; i < 35; ++i) {
+        shift = (shift << 1) | (data[i] >> 7);
+        for (int j = 0; j < 7; ++j) {
+            int bit = 7 * (34 - i) + j;
+            payload.limb[bit / 64] |= uint64_t((data[i] >> j) & 1) << (bit % 64);
+        }
+    }
+}
+
+void pack_bitwise(uint8_t* data, const uint239_limbs& payload, uint64_t shift) {
+    for (int i = 0; i < 35; ++i) {
+        uint8_t byte = ((shift >> (34 - i)) & 1) << 7;
+        for (int j = 0; j < 7; ++j) {
+            int bit = 7 * (34 - i) + j;
+            byte |= ((payload.limb[bit / 64] >> (bit % 64)) & 1) << j;
+        }
+        data[i] = byte;
+    }
+}
+
+template<typename Unpack, typename Pack>
+void measure(const char* name, std::vector<uint8_t> numbers, size_t count, int rounds, Unpack unpack, Pack pack) {
+    uint64_t checksum = 0;
+    auto begin = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < count; ++i) {
+            uint239_limbs payload;
+            uint64_t shift;
+            unpack(&numbers[35 * i], payload, shift);
+            checksum += payload.limb[r & 3] ^ shift;
+            payload.limb[0] += 1;
+            pack(&numbers[35 * i], payload, shift);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    double ns = seconds * 1e9 / (double(count) * rounds);
+    printf("%-10s %8.3f s %8.2f ns/number (unpack + pack)  checksum %llu\n", name, seconds, ns,
+           (unsigned long long) checksum);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    const int rounds = 8;
+    std::vector<uint8_t> numbers(35 * count);
+    uint64_t state = 239;
+    for (uint8_t& byte : numbers) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        byte = state >> 56;
+    }
+
+    measure("bitwise", numbers, count, rounds, unpack_bitwise, pack_bitwise);
+    for (CodecKind kind : {CodecKind::Portable, CodecKind::Bmi2}) {
+        if (kind == CodecKind::Bmi2 && best_codec() != CodecKind::Bmi2) {
+            continue;
+        }
+        measure(
+            codec_name(kind), numbers, count, rounds,
+            [kind](const uint8_t* data, uint239_limbs& payload, uint64_t& shift) { unpack_itmo(data, payload, shift, kind); },
+            [kind](uint8_t* data, const uint239_limbs& payload, uint64_t shift) { pack_itmo(data, payload, shift, kind); });
+    }
+    return 0;
+}
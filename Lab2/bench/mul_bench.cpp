@@ -0,0 +1,95 @@
+// Умножение uint239_t на случайных полноширинных числах: operator* и mul_overflow целиком
+// и отдельно произведения на словах (обрезанное 4 x 4, полное школьное, Карацуба),
+// для сравнения - сложение со сдвигом по одному биту, как было до limbs.h.
+// mul_bench [pairs], по умолчанию 4096 пар по кругу, пока не наберётся 4M умножений.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../lib/number.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// побитовое умножение: на каждый единичный бит b прибавляется a, сдвинутое на его номер
+uint239_limbs mul_shift_add(const uint239_limbs& a, const uint239_limbs& b) {
+    uint239_limbs r = limbs::zero();
+    for (int i = 0; i < limbs::bit_length(b); ++i) {
+        if ((b.limb[i / 64] >> (i % 64)) & 1) {
+            r = limbs::add(r, limbs::shift_left(a, i));
+        }
+    }
+    return r;
+}
+
+// все слова в контрольную сумму, иначе компилятор считает только нужное слово
+uint64_t fold(const uint64_t* limb, int count) {
+    uint64_t sum = 0;
+    for (int k = 0; k < count; ++k) {
+        sum = sum * 31 + limb[k];
+    }
+    return sum;
+}
+
+uint64_t fold(const uint239_t& value) {
+    uint64_t sum = 0;
+    for (uint8_t byte : value.data) {
+        sum = sum * 31 + byte;
+    }
+    return sum;
+}
+
+template<typename Operands, typename Multiply>
+void measure(const char* name, const std::vector<Operands>& lhs, const std::vector<Operands>& rhs, size_t total,
+             Multiply multiply) {
+    uint64_t checksum = 0;
+    auto begin = Clock::now();
+    for (size_t done = 0; done < total; done += lhs.size()) {
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            checksum += multiply(lhs[i], rhs[i]);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    size_t count = (total + lhs.size() - 1) / lhs.size() * lhs.size();
+    printf("%-20s %8.2f ns/mul  checksum %llu\n", name, seconds * 1e9 / count, (unsigned long long) checksum);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t pairs = argc > 1 ? strtoull(argv[1], nullptr, 10) : 4096;
+    const size_t total = 4000000;
+    std::vector<uint239_limbs> a(pairs), b(pairs);
+    std::vector<uint239_t> x(pairs), y(pairs);
+    uint64_t state = 239;
+    for (size_t i = 0; i < pairs; ++i) {
+        for (int k = 0; k < 4; ++k) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            a[i].limb[k] = state ^ (state >> 31);
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            b[i].limb[k] = state ^ (state >> 31);
+        }
+        a[i] = limbs::truncate(a[i]);
+        b[i] = limbs::truncate(b[i]);
+        x[i] = FromLimbs(a[i], state % 1000);
+        y[i] = FromLimbs(b[i], state % 777);
+    }
+
+    measure("operator*", x, y, total, [](const uint239_t& l, const uint239_t& r) { return fold(l * r); });
+    measure("mul_overflow", x, y, total, [](const uint239_t& l, const uint239_t& r) {
+        uint239_t result;
+        return mul_overflow(l, r, result) + fold(result);
+    });
+    measure("limbs::mul", a, b, total,
+            [](const uint239_limbs& l, const uint239_limbs& r) { return fold(limbs::mul(l, r).limb, 4); });
+    measure("mul_full", a, b, total,
+            [](const uint239_limbs& l, const uint239_limbs& r) { return fold(limbs::mul_full(l, r).limb, 8); });
+    measure("mul_full_karatsuba", a, b, total,
+            [](const uint239_limbs& l, const uint239_limbs& r) { return fold(limbs::mul_full_karatsuba(l, r).limb, 8); });
+    measure("shift_add", a, b, total / 20,
+            [](const uint239_limbs& l, const uint239_limbs& r) { return fold(mul_shift_add(l, r).limb, 4); });
+    return 0;
+}
@@ -0,0 +1,302 @@
+// Замер операций uint239_t на трёх распределениях операндов: small (< 2^32, без сдвига),
+// full (все 239 бит, без сдвига) и shifted (все 239 бит, случайный сдвиг < 2^35).
+// Результат - JSON: для каждой пары операция/распределение лучшее и среднее время из повторов
+// и контрольная сумма результатов, чтобы новую реализацию можно было сверить со старой.
+// number_bench [--numbers=4096] [--ops=1000000] [--repeats=5] [--seed=239] [--json=file]
+//              [--compare=old.json] [--tolerance=0.1]
+// С --compare печатает отношение к старому замеру и возвращает 2, если какая-то операция
+// стала медленнее больше чем на tolerance или её контрольная сумма изменилась.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "../lib/accumulator.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct BenchArgs {
+    size_t numbers = 4096;
+    size_t ops = 1000000; // не меньше стольких вызовов на один повтор
+    int repeats = 5;
+    uint64_t seed = 239;
+    std::string json_path;
+    std::string compare_path;
+    double tolerance = 0.1;
+};
+
+bool read_args(BenchArgs& args, int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq == std::string::npos ? arg.size() : eq + 1);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (name == "--numbers=") {
+            args.numbers = strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "--ops=") {
+            args.ops = strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "--repeats=") {
+            args.repeats = atoi(value.c_str());
+        } else if (name == "--seed=") {
+            args.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "--json=") {
+            args.json_path = value;
+        } else if (name == "--compare=") {
+            args.compare_path = value;
+        } else if (name == "--tolerance=") {
+            args.tolerance = atof(value.c_str());
+        } else {
+            return false;
+        }
+    }
+    return args.numbers >= 8 && args.repeats > 0; // sum8 берёт 8 чисел подряд по кругу
+}
+
+struct Random {
+    uint64_t state;
+
+    uint64_t next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state ^ (state >> 31);
+    }
+};
+
+// вывод в поток без памяти: только считает символы и складывает их в сумму
+class CountingBuffer : public std::streambuf {
+public:
+    uint64_t sum = 0;
+
+protected:
+    int_type overflow(int_type c) override {
+        sum = sum * 31 + c;
+        return c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        for (std::streamsize k = 0; k < n; ++k) {
+            sum = sum * 31 + s[k];
+        }
+        return n;
+    }
+};
+
+uint64_t fold(const uint239_t& value) {
+    uint64_t sum = 0;
+    for (uint8_t byte : value.data) {
+        sum = sum * 31 + byte;
+    }
+    return sum;
+}
+
+struct Operands {
+    const char* name;
+    std::vector<uint239_t> lhs;
+    std::vector<uint239_t> rhs;
+    std::vector<uint239_t> divisors; // ненулевые, длиной от 1 бита до длины lhs
+    std::vector<uint32_t> small;
+    std::vector<std::string> decimal;
+};
+
+uint239_limbs random_limbs(Random& random, bool full) {
+    if (!full) {
+        return uint239_limbs{{random.next() & 0xffffffff, 0, 0, 0}};
+    }
+    return limbs::truncate(uint239_limbs{{random.next(), random.next(), random.next(), random.next()}});
+}
+
+Operands make_operands(const char* name, size_t count, bool full, bool shifted, Random& random) {
+    Operands result;
+    result.name = name;
+    for (size_t i = 0; i < count; ++i) {
+        uint239_limbs a = random_limbs(random, full), b = random_limbs(random, full);
+        uint64_t sa = shifted ? random.next() % limbs::kShiftModulo : 0;
+        uint64_t sb = shifted ? random.next() % limbs::kShiftModulo : 0;
+        result.lhs.push_back(FromLimbs(a, sa));
+        result.rhs.push_back(FromLimbs(b, sb));
+
+        uint239_limbs d = limbs::shift_right(b, random.next() % std::max(limbs::bit_length(a), 1));
+        d.limb[0] |= 1;
+        result.divisors.push_back(FromLimbs(d, sb));
+
+        result.small.push_back(uint32_t(a.limb[0]));
+        std::ostringstream out;
+        out << FromLimbs(a, 0);
+        result.decimal.push_back(out.str());
+    }
+    return result;
+}
+
+// суммы всех кругов, чтобы повторы не выбрасывались компилятором
+volatile uint64_t sink = 0;
+
+struct Result {
+    std::string op;
+    std::string dist;
+    double best_ns = 0;
+    double mean_ns = 0;
+    uint64_t checksum = 0;
+};
+
+// call(i) возвращает вклад i-го вызова в контрольную сумму
+template<typename Call>
+Result measure(const char* op, const Operands& operands, const BenchArgs& args, Call call) {
+    size_t count = operands.lhs.size();
+    size_t rounds = std::max<size_t>(1, (args.ops + count - 1) / count);
+    Result result{op, operands.name};
+    double total = 0;
+    for (int repeat = 0; repeat < args.repeats; ++repeat) {
+        uint64_t checksum = 0;
+        auto begin = Clock::now();
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t i = 0; i < count; ++i) {
+                checksum += call(i);
+            }
+            if (round == 0) {
+                result.checksum = checksum; // остальные круги дают то же самое
+            }
+        }
+        double ns = std::chrono::duration<double>(Clock::now() - begin).count() * 1e9 / (rounds * count);
+        result.best_ns = repeat == 0 ? ns : std::min(result.best_ns, ns);
+        total += ns;
+        sink = sink + checksum;
+    }
+    result.mean_ns = total / args.repeats;
+    return result;
+}
+
+void measure_all(const Operands& o, const BenchArgs& args, std::vector<Result>& results) {
+    auto& lhs = o.lhs;
+    auto& rhs = o.rhs;
+    results.push_back(measure("FromInt", o, args, [&](size_t i) { return fold(FromInt(o.small[i], i)); }));
+    results.push_back(measure("FromString", o, args, [&](size_t i) { return fold(FromString(o.decimal[i].c_str(), i)); }));
+    results.push_back(measure("operator+", o, args, [&](size_t i) { return fold(lhs[i] + rhs[i]); }));
+    results.push_back(measure("operator-", o, args, [&](size_t i) { return fold(lhs[i] - rhs[i]); }));
+    results.push_back(measure("operator*", o, args, [&](size_t i) { return fold(lhs[i] * rhs[i]); }));
+    results.push_back(measure("operator/", o, args, [&](size_t i) { return fold(lhs[i] / o.divisors[i]); }));
+    results.push_back(measure("operator<<", o, args, [&](size_t i) {
+        CountingBuffer buffer;
+        std::ostream stream(&buffer);
+        stream << lhs[i];
+        return buffer.sum;
+    }));
+    results.push_back(measure("GetShift", o, args, [&](size_t i) { return GetShift(lhs[i]); }));
+    results.push_back(measure("operator==", o, args, [&](size_t i) -> uint64_t { return lhs[i] == rhs[i]; }));
+    results.push_back(measure("operator<", o, args, [&](size_t i) -> uint64_t { return lhs[i] < rhs[i]; }));
+
+    // цепочка из 8 слагаемых: по шагу operator+ и с одной сборкой в конце
+    auto at = [&](size_t i) -> const uint239_t& { return lhs[i < lhs.size() ? i : i - lhs.size()]; };
+    results.push_back(measure("sum8 operator+", o, args, [&](size_t i) {
+        return fold(at(i) + at(i + 1) + at(i + 2) + at(i + 3) + at(i + 4) + at(i + 5) + at(i + 6) + at(i + 7));
+    }));
+    results.push_back(measure("sum8 accumulator", o, args, [&](size_t i) {
+        return fold(uint239_accumulator(at(i)) + at(i + 1) + at(i + 2) + at(i + 3) + at(i + 4) + at(i + 5) + at(i + 6) +
+                    at(i + 7));
+    }));
+}
+
+// читает строки results, которые пишет этот же бенчмарк
+std::vector<Result> read_results(const std::string& path) {
+    std::vector<Result> results;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        char op[32], dist[32];
+        Result r;
+        unsigned long long checksum = 0;
+        if (sscanf(line.c_str(), " {\"op\": \"%31[^\"]\", \"dist\": \"%31[^\"]\", \"best_ns\": %lf, \"mean_ns\": %lf, "
+                                 "\"checksum\": %llu}",
+                   op, dist, &r.best_ns, &r.mean_ns, &checksum) == 5) {
+            r.op = op;
+            r.dist = dist;
+            r.checksum = checksum;
+            results.push_back(r);
+        }
+    }
+    return results;
+}
+
+// 0 - всё в пределах tolerance, 2 - есть замедление или другая контрольная сумма
+int compare_with(const std::vector<Result>& results, const std::vector<Result>& old, double tolerance) {
+    int status = 0;
+    fprintf(stderr, "%-16s %-8s %10s %10s %7s\n", "op", "dist", "old ns", "new ns", "ratio");
+    for (const Result& r : results) {
+        auto it = std::find_if(old.begin(), old.end(),
+                               [&](const Result& o) { return o.op == r.op && o.dist == r.dist; });
+        if (it == old.end()) {
+            continue;
+        }
+        double ratio = r.best_ns / it->best_ns;
+        const char* mark = "";
+        if (r.checksum != it->checksum) {
+            mark = "  checksum differs";
+            status = 2;
+        } else if (ratio > 1 + tolerance) {
+            mark = "  slower";
+            status = 2;
+        }
+        fprintf(stderr, "%-16s %-8s %10.2f %10.2f %7.2f%s\n", r.op.c_str(), r.dist.c_str(), it->best_ns, r.best_ns,
+                ratio, mark);
+    }
+    return status;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchArgs args;
+    if (!read_args(args, argc, argv)) {
+        fprintf(stderr, "usage: number_bench [--numbers=4096] [--ops=1000000] [--repeats=5] [--seed=239]\n"
+                        "                    [--json=path] [--compare=old.json] [--tolerance=0.1]\n");
+        return 1;
+    }
+
+    Random random{args.seed};
+    Operands distributions[] = {
+        make_operands("small", args.numbers, false, false, random),
+        make_operands("full", args.numbers, true, false, random),
+        make_operands("shifted", args.numbers, true, true, random),
+    };
+    std::vector<Result> results;
+    for (const Operands& operands : distributions) {
+        measure_all(operands, args, results);
+    }
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"codec\": \"" << codec_name(best_codec()) << "\",\n"
+         << "  \"numbers\": " << args.numbers << ", \"ops\": " << args.ops << ", \"repeats\": " << args.repeats
+         << ", \"seed\": " << args.seed << ",\n"
+         << "  \"results\": [\n";
+    for (size_t k = 0; k < results.size(); ++k) {
+        const Result& r = results[k];
+        json << "    {\"op\": \"" << r.op << "\", \"dist\": \"" << r.dist << "\", \"best_ns\": " << r.best_ns
+             << ", \"mean_ns\": " << r.mean_ns << ", \"checksum\": " << r.checksum << "}"
+             << (k + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n"
+         << "}\n";
+    if (args.json_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream(args.json_path) << json.str();
+    }
+
+    if (!args.compare_path.empty()) {
+        std::vector<Result> old = read_results(args.compare_path);
+        if (old.empty()) {
+            fprintf(stderr, "cannot read results from %s\n", args.compare_path.c_str());
+            return 1;
+        }
+        return compare_with(results, old, args.tolerance);
+    }
+    return 0;
+}
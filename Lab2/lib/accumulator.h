@@ -0,0 +1,93 @@
+#pragma once
+#include <cinttypes>
+
+#include "number.h"
+
+// Цепочка a + b + c + ... без сборки ITMO Endian на каждом шаге: значение хранится словами без сдвига,
+// как в ToLimbs, а сдвиг - отдельным числом. Каждое слагаемое разбирается один раз, а результат
+// собирается один раз - в get() или при преобразовании в uint_itmo_t. Результат тот же, что у цепочки
+// operator+ / operator- / operator*: значения берутся по модулю 2^Bits, сдвиги складываются
+// (вычитаются) по модулю 2^kShiftBits.
+//
+//   uint239_t sum = uint239_accumulator(a) + b + c + d;
+//
+//   uint239_accumulator total;
+//   for (const uint239_t& x : values) {
+//       total += x;
+//   }
+template<int Bits>
+class uint_itmo_accumulator {
+public:
+    constexpr uint_itmo_accumulator() : value{}, shift(0) {}
+
+    constexpr explicit uint_itmo_accumulator(const uint_itmo_t<Bits>& start) : value{}, shift(0) {
+        value = ToLimbs(start, shift);
+    }
+
+    constexpr uint_itmo_accumulator& operator+=(const uint_itmo_t<Bits>& rhs) {
+        limbs::shift_t<Bits> rs = 0;
+        value = limbs::add(value, ToLimbs(rhs, rs));
+        shift += rs;
+        return *this;
+    }
+
+    constexpr uint_itmo_accumulator& operator-=(const uint_itmo_t<Bits>& rhs) {
+        limbs::shift_t<Bits> rs = 0;
+        value = limbs::sub(value, ToLimbs(rhs, rs));
+        shift -= rs;
+        return *this;
+    }
+
+    constexpr uint_itmo_accumulator& operator*=(const uint_itmo_t<Bits>& rhs) {
+        limbs::shift_t<Bits> rs = 0;
+        value = limbs::mul(value, ToLimbs(rhs, rs));
+        shift += rs;
+        return *this;
+    }
+
+    // две частичные суммы складываются без разбора вовсе
+    constexpr uint_itmo_accumulator& operator+=(const uint_itmo_accumulator& rhs) {
+        value = limbs::add(value, rhs.value);
+        shift += rhs.shift;
+        return *this;
+    }
+
+    constexpr uint_itmo_accumulator operator+(const uint_itmo_t<Bits>& rhs) const {
+        uint_itmo_accumulator r = *this;
+        return r += rhs;
+    }
+
+    constexpr uint_itmo_accumulator operator-(const uint_itmo_t<Bits>& rhs) const {
+        uint_itmo_accumulator r = *this;
+        return r -= rhs;
+    }
+
+    constexpr uint_itmo_accumulator operator*(const uint_itmo_t<Bits>& rhs) const {
+        uint_itmo_accumulator r = *this;
+        return r *= rhs;
+    }
+
+    // значение без сдвига; сдвиг - по модулю 2^kShiftBits
+    constexpr const uint_limbs<Bits>& to_limbs() const {
+        return value;
+    }
+
+    constexpr limbs::shift_t<Bits> get_shift() const {
+        return shift & limbs::layout<Bits>::kShiftMask;
+    }
+
+    // единственная сборка ITMO Endian
+    constexpr uint_itmo_t<Bits> get() const {
+        return FromLimbs(value, shift);
+    }
+
+    constexpr operator uint_itmo_t<Bits>() const {
+        return get();
+    }
+
+private:
+    uint_limbs<Bits> value;
+    limbs::shift_t<Bits> shift; // без маски: лишние старшие биты отбрасывает FromLimbs
+};
+
+using uint239_accumulator = uint_itmo_accumulator<239>;
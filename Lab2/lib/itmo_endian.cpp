@@ -0,0 +1,51 @@
+#include "itmo_endian.h"
+
+using namespace itmo_endian;
+
+#ifdef NUMBER_BMI2
+void unpack_itmo_bmi2(const uint8_t* data, uint239_limbs& payload, uint64_t& shift);
+void pack_itmo_bmi2(uint8_t* data, const uint239_limbs& payload, uint64_t shift);
+#endif
+
+CodecKind best_codec() {
+#ifdef NUMBER_BMI2
+    if (__builtin_cpu_supports("bmi2")) {
+        return CodecKind::Bmi2;
+    }
+#endif
+    return CodecKind::Portable;
+}
+
+const char* codec_name(CodecKind kind) {
+    return kind == CodecKind::Bmi2 ? "bmi2" : "portable";
+}
+
+void unpack_itmo(const uint8_t* data, uint239_limbs& payload, uint64_t& shift, CodecKind kind) {
+#ifdef NUMBER_BMI2
+    if (kind == CodecKind::Bmi2) {
+        unpack_itmo_bmi2(data, payload, shift);
+        return;
+    }
+#endif
+    unpack_portable(data, payload, shift);
+}
+
+void pack_itmo(uint8_t* data, const uint239_limbs& payload, uint64_t shift, CodecKind kind) {
+#ifdef NUMBER_BMI2
+    if (kind == CodecKind::Bmi2) {
+        pack_itmo_bmi2(data, payload, shift);
+        return;
+    }
+#endif
+    pack_portable(data, payload, shift);
+}
+
+void unpack_itmo_best(const uint8_t* data, uint239_limbs& payload, uint64_t& shift) {
+    static const CodecKind kind = best_codec();
+    unpack_itmo(data, payload, shift, kind);
+}
+
+void pack_itmo_best(uint8_t* data, const uint239_limbs& payload, uint64_t shift) {
+    static const CodecKind kind = best_codec();
+    pack_itmo(data, payload, shift, kind);
+}
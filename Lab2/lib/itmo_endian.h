@@ -0,0 +1,185 @@
+#pragma once
+#include <bit>
+#include <cinttypes>
+#include <cstring>
+#include <type_traits>
+
+#include "limbs.h"
+
+// Разбор и сборка ITMO Endian целыми словами, без циклов по битам.
+// Байты с конца делятся на группы по 8 (для uint239_t: data[27..34], data[19..26], data[11..18],
+// data[3..10]) и хвост в начале (data[0..2]). Группа читается как big endian слово: младшие 7 бит
+// каждого байта дают 56 бит полезной нагрузки, старшие биты - 8 бит сдвига. Нагрузка здесь без учёта
+// сдвига, в том порядке, в каком она лежит в байтах: бит 7 * (kBytes - 1 - i) + j - это бит j байта data[i].
+// Переносимый вариант - шаблон для любой ширины, для uint239_t во время работы есть ещё BMI2.
+
+enum class CodecKind {
+    Portable,
+    Bmi2,
+};
+
+CodecKind best_codec();
+const char* codec_name(CodecKind kind);
+
+void unpack_itmo(const uint8_t* data, uint239_limbs& payload, uint64_t& shift, CodecKind kind);
+void pack_itmo(uint8_t* data, const uint239_limbs& payload, uint64_t shift, CodecKind kind);
+
+// то же самое для uint239_t лучшим доступным способом, выбранным один раз
+void unpack_itmo_best(const uint8_t* data, uint239_limbs& payload, uint64_t& shift);
+void pack_itmo_best(uint8_t* data, const uint239_limbs& payload, uint64_t shift);
+
+namespace itmo_endian {
+
+constexpr uint64_t kLowBits = 0x7f7f7f7f7f7f7f7full;
+constexpr uint64_t kHighBits = 0x8080808080808080ull;
+constexpr uint64_t kGroupMask = (1ull << 56) - 1;
+
+// начала групп в data, от младшей к старшей; хвост - 3 байта с data[0]
+constexpr int kGroupStart[4] = {27, 19, 11, 3};
+
+constexpr uint64_t load_group(const uint8_t* data, int start, int count) {
+    if (!std::is_constant_evaluated() && count == 8 && std::endian::native == std::endian::little) {
+        uint64_t word = 0;
+        memcpy(&word, data + start, 8);
+        return __builtin_bswap64(word);
+    }
+    uint64_t word = 0;
+    for (int i = 0; i < count; ++i) {
+        word = (word << 8) | data[start + i];
+    }
+    return word;
+}
+
+constexpr void store_group(uint8_t* data, int start, int count, uint64_t word) {
+    if (!std::is_constant_evaluated() && count == 8 && std::endian::native == std::endian::little) {
+        word = __builtin_bswap64(word);
+        memcpy(data + start, &word, 8);
+        return;
+    }
+    for (int i = count - 1; i >= 0; --i, word >>= 8) {
+        data[start + i] = word;
+    }
+}
+
+// младшие 7 бит каждого байта подряд, как _pext_u64(word, kLowBits)
+constexpr uint64_t compress7(uint64_t word) {
+    uint64_t x = word & kLowBits;
+    x = (x & 0x007f007f007f007full) | ((x >> 1) & 0x3f803f803f803f80ull);
+    x = (x & 0x00003fff00003fffull) | ((x >> 2) & 0x0fffc0000fffc000ull);
+    x = (x & 0x000000000fffffffull) | ((x >> 4) & 0x00fffffff0000000ull);
+    return x;
+}
+
+// обратно: 56 бит по 7 в каждый байт, как _pdep_u64(bits, kLowBits)
+constexpr uint64_t expand7(uint64_t bits) {
+    uint64_t x = bits & kGroupMask;
+    x = (x & 0x000000000fffffffull) | ((x << 4) & 0x0fffffff00000000ull);
+    x = (x & 0x00003fff00003fffull) | ((x << 2) & 0x3fff00003fff0000ull);
+    x = (x & 0x007f007f007f007full) | ((x << 1) & 0x7f007f007f007f00ull);
+    return x;
+}
+
+// старшие биты байтов в 8 бит одним умножением: слагаемые не пересекаются, переносов нет
+constexpr uint64_t gather_high(uint64_t word) {
+    return (((word & kHighBits) >> 7) * 0x0102040810204080ull) >> 56;
+}
+
+constexpr uint64_t scatter_high(uint64_t bits) {
+    uint64_t x = bits & 0xff;
+    x = (x | (x << 28)) & 0x0000000f0000000full;
+    x = (x | (x << 14)) & 0x0003000300030003ull;
+    x = (x | (x << 7)) & 0x0101010101010101ull;
+    return x << 7;
+}
+
+// для BMI2-версии uint239_t: 4 куска по 56 бит и хвост в 21 бит склеиваются в 245 бит
+constexpr void join_groups(const uint64_t* part, uint239_limbs& payload) {
+    payload.limb[0] = part[0] | (part[1] << 56);
+    payload.limb[1] = (part[1] >> 8) | (part[2] << 48);
+    payload.limb[2] = (part[2] >> 16) | (part[3] << 40);
+    payload.limb[3] = (part[3] >> 24) | (part[4] << 32);
+}
+
+constexpr void split_groups(const uint239_limbs& payload, uint64_t* part) {
+    part[0] = payload.limb[0] & kGroupMask;
+    part[1] = ((payload.limb[0] >> 56) | (payload.limb[1] << 8)) & kGroupMask;
+    part[2] = ((payload.limb[1] >> 48) | (payload.limb[2] << 16)) & kGroupMask;
+    part[3] = ((payload.limb[2] >> 40) | (payload.limb[3] << 24)) & kGroupMask;
+    part[4] = (payload.limb[3] >> 32) & 0x1fffff;
+}
+
+// count <= 56 бит нагрузки начиная с бита bit
+template<int Bits>
+constexpr uint64_t take_bits(const uint_limbs<Bits>& payload, int bit, int count) {
+    int word = bit / 64, offset = bit % 64;
+    uint64_t x = payload.limb[word] >> offset;
+    if (offset + count > 64) {
+        x |= payload.limb[word + 1] << (64 - offset);
+    }
+    return x & ((1ull << count) - 1);
+}
+
+template<int Bits>
+constexpr void put_bits(uint_limbs<Bits>& payload, int bit, int count, uint64_t x) {
+    int word = bit / 64, offset = bit % 64;
+    payload.limb[word] |= x << offset;
+    if (offset + count > 64) {
+        payload.limb[word + 1] |= x >> (64 - offset);
+    }
+}
+
+template<int Bits>
+constexpr void unpack_portable(const uint8_t* data, uint_limbs<Bits>& payload, limbs::shift_t<Bits>& shift) {
+    constexpr int bytes = limbs::layout<Bits>::kBytes, groups = bytes / 8, tail = bytes % 8;
+    payload = uint_limbs<Bits>{};
+    shift = 0;
+    limbs::unroll<groups>([&](int g) {
+        uint64_t word = load_group(data, bytes - 8 * (g + 1), 8);
+        put_bits(payload, 56 * g, 56, compress7(word));
+        shift |= limbs::shift_t<Bits>(gather_high(word)) << (8 * g);
+    });
+    if constexpr (tail > 0) {
+        uint64_t word = load_group(data, 0, tail);
+        put_bits(payload, 56 * groups, 7 * tail, compress7(word));
+        shift |= limbs::shift_t<Bits>(gather_high(word)) << (8 * groups);
+    }
+}
+
+template<int Bits>
+constexpr void pack_portable(uint8_t* data, const uint_limbs<Bits>& payload, limbs::shift_t<Bits> shift) {
+    constexpr int bytes = limbs::layout<Bits>::kBytes, groups = bytes / 8, tail = bytes % 8;
+    limbs::unroll<groups>([&](int g) {
+        uint64_t high = scatter_high(uint64_t(shift >> (8 * g)));
+        store_group(data, bytes - 8 * (g + 1), 8, expand7(take_bits(payload, 56 * g, 56)) | high);
+    });
+    if constexpr (tail > 0) {
+        uint64_t high = scatter_high(uint64_t(shift >> (8 * groups)) & ((1u << tail) - 1));
+        store_group(data, 0, tail, expand7(take_bits(payload, 56 * groups, 7 * tail)) | high);
+    }
+}
+
+} // namespace itmo_endian
+
+// при вычислении во время компиляции и для других ширин - portable, для uint239_t во время работы -
+// лучший вариант
+template<int Bits>
+constexpr void unpack_itmo(const uint8_t* data, uint_limbs<Bits>& payload, limbs::shift_t<Bits>& shift) {
+    if constexpr (Bits == 239) {
+        if (!std::is_constant_evaluated()) {
+            unpack_itmo_best(data, payload, shift);
+            return;
+        }
+    }
+    itmo_endian::unpack_portable(data, payload, shift);
+}
+
+template<int Bits>
+constexpr void pack_itmo(uint8_t* data, const uint_limbs<Bits>& payload, limbs::shift_t<Bits> shift) {
+    if constexpr (Bits == 239) {
+        if (!std::is_constant_evaluated()) {
+            pack_itmo_best(data, payload, shift);
+            return;
+        }
+    }
+    itmo_endian::pack_portable(data, payload, shift);
+}
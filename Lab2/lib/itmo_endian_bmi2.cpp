@@ -0,0 +1,29 @@
+// собирается с -mbmi2, вызывается только если процессор поддерживает BMI2
+#include "itmo_endian.h"
+
+#include <immintrin.h>
+
+using namespace itmo_endian;
+
+void unpack_itmo_bmi2(const uint8_t* data, uint239_limbs& payload, uint64_t& shift) {
+    uint64_t part[5];
+    shift = 0;
+    for (int g = 0; g < 4; ++g) {
+        uint64_t word = load_group(data, kGroupStart[g], 8);
+        part[g] = _pext_u64(word, kLowBits);
+        shift |= _pext_u64(word, kHighBits) << (8 * g);
+    }
+    uint64_t tail = load_group(data, 0, 3);
+    part[4] = _pext_u64(tail, kLowBits);
+    shift |= _pext_u64(tail, kHighBits) << 32;
+    join_groups(part, payload);
+}
+
+void pack_itmo_bmi2(uint8_t* data, const uint239_limbs& payload, uint64_t shift) {
+    uint64_t part[5];
+    split_groups(payload, part);
+    for (int g = 0; g < 4; ++g) {
+        store_group(data, kGroupStart[g], 8, _pdep_u64(part[g], kLowBits) | _pdep_u64(shift >> (8 * g), kHighBits));
+    }
+    store_group(data, 0, 3, _pdep_u64(part[4], kLowBits) | _pdep_u64((shift >> 32) & 0x7, kHighBits));
+}
@@ -0,0 +1,467 @@
+#pragma once
+#include <bit>
+#include <cinttypes>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace limbs {
+
+// Раскладка ITMO Endian числа из Bits значимых бит: на каждые 7 бит байт, старший бит каждого
+// байта - служебный бит сдвига. Всё считается при компиляции из одного Bits.
+template<int Bits>
+struct layout {
+    static constexpr int kBytes = (Bits + 6) / 7;
+    static constexpr int kPayloadBits = 7 * kBytes; // значимые и padding биты: по кругу сдвигаются все
+    static constexpr int kShiftBits = kBytes;
+    static constexpr int kCount = (kPayloadBits + 63) / 64; // слов по 64 бита
+    static constexpr uint64_t kPayloadTop = ~0ull >> (64 * kCount - kPayloadBits); // занятые биты старшего слова
+    // десятичных цифр в kCount словах, с запасом до целого числа кусков по 18 цифр
+    static constexpr int kDecimalDigits = (64 * kCount * 30103 / 100000 + 1 + 17) / 18 * 18;
+
+    static_assert(kShiftBits < 128, "shift must fit into unsigned __int128");
+    using shift_type = std::conditional_t<(kShiftBits < 64), uint64_t, unsigned __int128>;
+    static constexpr shift_type kShiftMask = (shift_type(1) << kShiftBits) - 1;
+};
+
+template<int Bits>
+using shift_t = typename layout<Bits>::shift_type;
+
+// f(0), f(1), ..., f(N - 1), номер приходит как std::integral_constant: циклы по словам
+// разворачиваются при компиляции, и для каждой ширины получается свой код без проверок длины
+template<int N, typename F>
+constexpr void unroll(F&& f) {
+    [&]<int... I>(std::integer_sequence<int, I...>) {
+        (f(std::integral_constant<int, I>{}), ...);
+    }(std::make_integer_sequence<int, N>{});
+}
+
+// биты значения в слове i
+template<int Bits>
+constexpr uint64_t value_mask(int i) {
+    int bits = Bits - 64 * i;
+    return bits >= 64 ? ~0ull : bits <= 0 ? 0 : (1ull << bits) - 1;
+}
+
+} // namespace limbs
+
+// Значение без сдвига в двоичном виде: слова по 64 бита, младшее первым.
+// Вся арифметика идёт над ними, а ITMO Endian разбирается и собирается только на входе и выходе.
+// Результаты берутся по модулю 2^Bits, поэтому padding биты всегда нули.
+// Все функции constexpr, чтобы константы и литералы считались при компиляции.
+template<int Bits>
+struct uint_limbs {
+    uint64_t limb[limbs::layout<Bits>::kCount];
+};
+
+// Полное произведение двух таких чисел без обрезки по модулю: вдвое больше слов
+// (для 239 бит - 478, с padding битами после DoShift - до 490).
+template<int Bits>
+struct uint_product {
+    uint64_t limb[2 * limbs::layout<Bits>::kCount];
+};
+
+using uint239_limbs = uint_limbs<239>;
+using uint478_limbs = uint_product<239>;
+
+namespace limbs {
+
+// константы uint239_t, на которых построены uint239_array и его AVX2-ядра
+constexpr int kPayloadBits = layout<239>::kPayloadBits;
+constexpr uint64_t kShiftModulo = layout<239>::kShiftMask + 1; // 2^35
+constexpr uint64_t kPayloadTop = layout<239>::kPayloadTop;
+constexpr uint64_t kValueTop = value_mask<239>(3);
+
+template<int Bits = 239>
+constexpr uint_limbs<Bits> zero() {
+    return uint_limbs<Bits>{};
+}
+
+template<int Bits>
+constexpr bool is_zero(const uint_limbs<Bits>& a) {
+    uint64_t any = 0;
+    unroll<layout<Bits>::kCount>([&](int i) { any |= a.limb[i]; });
+    return any == 0;
+}
+
+// число значимых бит, 0 для нуля
+template<int Bits>
+constexpr int bit_length(const uint_limbs<Bits>& a) {
+    for (int i = layout<Bits>::kCount - 1; i >= 0; --i) {
+        if (a.limb[i]) {
+            return 64 * i + 64 - std::countl_zero(a.limb[i]);
+        }
+    }
+    return 0;
+}
+
+template<int Bits>
+constexpr int compare(const uint_limbs<Bits>& a, const uint_limbs<Bits>& b) {
+    for (int i = layout<Bits>::kCount - 1; i >= 0; --i) {
+        if (a.limb[i] != b.limb[i]) {
+            return a.limb[i] < b.limb[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// 0 <= n < 64 * kCount
+template<int Bits>
+constexpr uint_limbs<Bits> shift_left(const uint_limbs<Bits>& a, int n) {
+    constexpr int count = layout<Bits>::kCount;
+    uint_limbs<Bits> r{};
+    int words = n / 64, bits = n % 64;
+    for (int i = count - 1; i >= words; --i) {
+        r.limb[i] = a.limb[i - words] << bits;
+        if (bits && i - words > 0) {
+            r.limb[i] |= a.limb[i - words - 1] >> (64 - bits);
+        }
+    }
+    return r;
+}
+
+template<int Bits>
+constexpr uint_limbs<Bits> shift_right(const uint_limbs<Bits>& a, int n) {
+    constexpr int count = layout<Bits>::kCount;
+    uint_limbs<Bits> r{};
+    int words = n / 64, bits = n % 64;
+    for (int i = 0; i + words < count; ++i) {
+        r.limb[i] = a.limb[i + words] >> bits;
+        if (bits && i + words < count - 1) {
+            r.limb[i] |= a.limb[i + words + 1] << (64 - bits);
+        }
+    }
+    return r;
+}
+
+// циклический сдвиг всех kPayloadBits бит влево, как его задаёт ITMO Endian
+template<int Bits>
+constexpr uint_limbs<Bits> rotate_left(const uint_limbs<Bits>& a, uint64_t n) {
+    constexpr int payload_bits = layout<Bits>::kPayloadBits;
+    n %= payload_bits;
+    if (n == 0) {
+        return a;
+    }
+    uint_limbs<Bits> l = shift_left(a, n), r = shift_right(a, payload_bits - n);
+    unroll<layout<Bits>::kCount>([&](int i) { l.limb[i] |= r.limb[i]; });
+    l.limb[layout<Bits>::kCount - 1] &= layout<Bits>::kPayloadTop;
+    return l;
+}
+
+// младшие Bits бит
+template<int Bits>
+constexpr uint_limbs<Bits> truncate(uint_limbs<Bits> a) {
+    unroll<layout<Bits>::kCount>([&](int i) { a.limb[i] &= value_mask<Bits>(i); });
+    return a;
+}
+
+template<int Bits>
+constexpr uint_limbs<Bits> add(const uint_limbs<Bits>& a, const uint_limbs<Bits>& b) {
+    uint_limbs<Bits> r{};
+    unsigned __int128 carry = 0;
+    unroll<layout<Bits>::kCount>([&](int i) {
+        carry += (unsigned __int128) a.limb[i] + b.limb[i];
+        r.limb[i] = (uint64_t) carry;
+        carry >>= 64;
+    });
+    return truncate(r);
+}
+
+template<int Bits>
+constexpr uint_limbs<Bits> sub(const uint_limbs<Bits>& a, const uint_limbs<Bits>& b) {
+    uint_limbs<Bits> r{};
+    uint64_t borrow = 0;
+    unroll<layout<Bits>::kCount>([&](int i) {
+        uint64_t x = a.limb[i] - b.limb[i];
+        uint64_t next = (a.limb[i] < b.limb[i]) | (x < borrow);
+        r.limb[i] = x - borrow;
+        borrow = next;
+    });
+    return truncate(r);
+}
+
+// школьное умножение, нужны только младшие kCount слов произведения
+// (для 239 бит - 10 умножений 64 x 64 вместо 16)
+template<int Bits>
+constexpr uint_limbs<Bits> mul(const uint_limbs<Bits>& a, const uint_limbs<Bits>& b) {
+    constexpr int count = layout<Bits>::kCount;
+    uint_limbs<Bits> r{};
+    unroll<count>([&](auto i) {
+        unsigned __int128 carry = 0;
+        unroll<count - i>([&](auto j) {
+            unsigned __int128 t = (unsigned __int128) a.limb[i] * b.limb[j] + r.limb[i + j] + carry;
+            r.limb[i + j] = (uint64_t) t;
+            carry = t >> 64;
+        });
+    });
+    return truncate(r);
+}
+
+// полное школьное умножение kCount x kCount слов: зато видно переполнение
+template<int Bits>
+constexpr uint_product<Bits> mul_full(const uint_limbs<Bits>& a, const uint_limbs<Bits>& b) {
+    constexpr int count = layout<Bits>::kCount;
+    uint_product<Bits> r{};
+    unroll<count>([&](int i) {
+        unsigned __int128 carry = 0;
+        unroll<count>([&](int j) {
+            unsigned __int128 t = (unsigned __int128) a.limb[i] * b.limb[j] + r.limb[i + j] + carry;
+            r.limb[i + j] = (uint64_t) t;
+            carry = t >> 64;
+        });
+        r.limb[i + count] = (uint64_t) carry;
+    });
+    return r;
+}
+
+// dst[0..n) += src[0..m), m <= n, перенос идёт до конца dst
+constexpr void add_into(uint64_t* dst, int n, const uint64_t* src, int m) {
+    unsigned __int128 carry = 0;
+    for (int i = 0; i < n && (i < m || carry); ++i) {
+        carry += (unsigned __int128) dst[i] + (i < m ? src[i] : 0);
+        dst[i] = (uint64_t) carry;
+        carry >>= 64;
+    }
+}
+
+// dst[0..n) -= src[0..m), результат не отрицательный
+constexpr void sub_from(uint64_t* dst, int n, const uint64_t* src, int m) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < n && (i < m || borrow); ++i) {
+        uint64_t y = i < m ? src[i] : 0;
+        uint64_t x = dst[i] - y;
+        uint64_t next = (dst[i] < y) | (x < borrow);
+        dst[i] = x - borrow;
+        borrow = next;
+    }
+}
+
+// 2 x 2 слова -> 4 слова
+constexpr void mul_2x2(const uint64_t* a, const uint64_t* b, uint64_t* r) {
+    unsigned __int128 low = (unsigned __int128) a[0] * b[0];
+    unsigned __int128 mid1 = (unsigned __int128) a[0] * b[1];
+    unsigned __int128 mid2 = (unsigned __int128) a[1] * b[0];
+    unsigned __int128 high = (unsigned __int128) a[1] * b[1];
+    r[0] = (uint64_t) low;
+    unsigned __int128 t = (low >> 64) + (uint64_t) mid1 + (uint64_t) mid2;
+    r[1] = (uint64_t) t;
+    t = (t >> 64) + (mid1 >> 64) + (mid2 >> 64) + (uint64_t) high;
+    r[2] = (uint64_t) t;
+    r[3] = (uint64_t) ((t >> 64) + (high >> 64));
+}
+
+// то же произведение по Карацубе на половинах по 128 бит: 3 умножения 2 x 2 вместо 4.
+// (a1 B + a0)(b1 B + b0) = z2 B^2 + ((a0 + a1)(b0 + b1) - z0 - z2) B + z0, B = 2^128
+constexpr uint478_limbs mul_full_karatsuba(const uint239_limbs& a, const uint239_limbs& b) {
+    uint478_limbs r{};
+    mul_2x2(a.limb, b.limb, r.limb);
+    mul_2x2(a.limb + 2, b.limb + 2, r.limb + 4);
+
+    // суммы половин - до 129 бит: 2 слова и старший бит в третьем
+    uint64_t sum_a[3] = {a.limb[0], a.limb[1], 0};
+    uint64_t sum_b[3] = {b.limb[0], b.limb[1], 0};
+    add_into(sum_a, 3, a.limb + 2, 2);
+    add_into(sum_b, 3, b.limb + 2, 2);
+
+    uint64_t middle[5] = {};
+    mul_2x2(sum_a, sum_b, middle);
+    if (sum_a[2]) {
+        add_into(middle + 2, 3, sum_b, 2);
+    }
+    if (sum_b[2]) {
+        add_into(middle + 2, 3, sum_a, 2);
+    }
+    middle[4] += sum_a[2] & sum_b[2];
+    sub_from(middle, 5, r.limb, 4);
+    sub_from(middle, 5, r.limb + 4, 4);
+    add_into(r.limb + 2, 6, middle, 5);
+    return r;
+}
+
+// младшие Bits бит произведения
+template<int Bits>
+constexpr uint_limbs<Bits> truncate(const uint_product<Bits>& a) {
+    uint_limbs<Bits> r{};
+    unroll<layout<Bits>::kCount>([&](int i) { r.limb[i] = a.limb[i]; });
+    return truncate(r);
+}
+
+// не влезает в Bits бит
+template<int Bits>
+constexpr bool overflows(const uint_product<Bits>& a) {
+    uint64_t high = 0;
+    unroll<2 * layout<Bits>::kCount>([&](int i) { high |= a.limb[i] & ~value_mask<Bits>(i); });
+    return high != 0;
+}
+
+// a * m + add для маленьких m
+template<int Bits>
+constexpr uint_limbs<Bits> mul_small(const uint_limbs<Bits>& a, uint64_t m, uint64_t add) {
+    uint_limbs<Bits> r{};
+    unsigned __int128 carry = add;
+    unroll<layout<Bits>::kCount>([&](int i) {
+        unsigned __int128 t = (unsigned __int128) a.limb[i] * m + carry;
+        r.limb[i] = (uint64_t) t;
+        carry = t >> 64;
+    });
+    return truncate(r);
+}
+
+// a / d и остаток для d < 2^64: по одному делению 128 на 64 бита на слово
+template<int Bits>
+constexpr uint_limbs<Bits> divmod_small(const uint_limbs<Bits>& a, uint64_t d, uint64_t& rest) {
+    uint_limbs<Bits> q{};
+    unsigned __int128 r = 0;
+    for (int i = layout<Bits>::kCount - 1; i >= 0; --i) {
+        r = (r << 64) | a.limb[i];
+        q.limb[i] = (uint64_t) (r / d);
+        r %= d;
+    }
+    rest = (uint64_t) r;
+    return q;
+}
+
+// деление столбиком по словам (Кнут, том 2, 4.3.1, алгоритм D)
+template<int Bits>
+constexpr uint_limbs<Bits> divide(const uint_limbs<Bits>& a, const uint_limbs<Bits>& b) {
+    constexpr int count = layout<Bits>::kCount;
+    if (is_zero(b)) {
+        throw std::domain_error("uint_itmo_t division by zero");
+    }
+    if (compare(a, b) < 0) {
+        return uint_limbs<Bits>{};
+    }
+    int n = count;
+    while (b.limb[n - 1] == 0) {
+        n--;
+    }
+    if (n == 1) {
+        uint64_t rest = 0;
+        return divmod_small(a, b.limb[0], rest);
+    }
+
+    // делитель сдвигается так, чтобы старший бит старшего слова был 1: тогда оценка qhat
+    // по двум старшим словам ошибается не больше чем на 2
+    int s = std::countl_zero(b.limb[n - 1]);
+    uint64_t v[count] = {};
+    uint64_t u[count + 1] = {};
+    for (int i = n - 1; i >= 0; --i) {
+        v[i] = (b.limb[i] << s) | (s && i > 0 ? b.limb[i - 1] >> (64 - s) : 0);
+    }
+    u[count] = s ? a.limb[count - 1] >> (64 - s) : 0;
+    for (int i = count - 1; i >= 0; --i) {
+        u[i] = (a.limb[i] << s) | (s && i > 0 ? a.limb[i - 1] >> (64 - s) : 0);
+    }
+
+    uint_limbs<Bits> q{};
+    const unsigned __int128 base = (unsigned __int128) 1 << 64;
+    for (int j = count - n; j >= 0; --j) {
+        unsigned __int128 num = ((unsigned __int128) u[j + n] << 64) | u[j + n - 1];
+        unsigned __int128 qhat = num / v[n - 1];
+        unsigned __int128 rhat = num % v[n - 1];
+        while (qhat >= base || qhat * v[n - 2] > ((rhat << 64) | u[j + n - 2])) {
+            qhat--;
+            rhat += v[n - 1];
+            if (rhat >= base) {
+                break;
+            }
+        }
+
+        // u[j..j+n] -= qhat * v
+        uint64_t carry = 0, borrow = 0;
+        for (int i = 0; i < n; ++i) {
+            unsigned __int128 p = qhat * v[i] + carry;
+            carry = (uint64_t) (p >> 64);
+            uint64_t low = (uint64_t) p;
+            uint64_t t = u[i + j] - low;
+            uint64_t next = u[i + j] < low;
+            next |= t < borrow;
+            u[i + j] = t - borrow;
+            borrow = next;
+        }
+        uint64_t t = u[j + n] - carry;
+        bool negative = u[j + n] < carry || t < borrow;
+        u[j + n] = t - borrow;
+
+        // qhat оказался на 1 больше: возвращаем v обратно
+        if (negative) {
+            qhat--;
+            unsigned __int128 sum = 0;
+            for (int i = 0; i < n; ++i) {
+                sum += (unsigned __int128) u[i + j] + v[i];
+                u[i + j] = (uint64_t) sum;
+                sum >>= 64;
+            }
+            u[j + n] += (uint64_t) sum;
+        }
+        q.limb[j] = (uint64_t) qhat;
+    }
+    return q;
+}
+
+constexpr uint64_t kChunk = 1000000000000000000ull; // 10^18, столько цифр разом в десятичном переводе
+constexpr int kChunkDigits = 18;
+
+constexpr char kDigitPairs[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+// ровно 9 цифр v < 10^9, по две за раз
+constexpr void write_nine_digits(char* p, uint32_t v) {
+    for (int i = 7; i >= 1; i -= 2, v /= 100) {
+        p[i] = kDigitPairs[2 * (v % 100)];
+        p[i + 1] = kDigitPairs[2 * (v % 100) + 1];
+    }
+    p[0] = '0' + v;
+}
+
+// десятичная запись без ведущих нулей в buffer (хотя бы layout<Bits>::kDecimalDigits байт),
+// возвращает длину
+template<int Bits>
+constexpr int to_decimal(const uint_limbs<Bits>& a, char* buffer) {
+    constexpr int kMaxDigits = layout<Bits>::kDecimalDigits;
+    char digits[kMaxDigits] = {};
+    int pos = kMaxDigits;
+    uint_limbs<Bits> rest = a;
+    do {
+        uint64_t chunk = 0;
+        rest = divmod_small(rest, kChunk, chunk);
+        pos -= kChunkDigits;
+        write_nine_digits(digits + pos, chunk / 1000000000);
+        write_nine_digits(digits + pos + 9, chunk % 1000000000);
+    } while (!is_zero(rest));
+
+    while (pos < kMaxDigits - 1 && digits[pos] == '0') {
+        pos++;
+    }
+    for (int i = pos; i < kMaxDigits; ++i) {
+        buffer[i - pos] = digits[i];
+    }
+    return kMaxDigits - pos;
+}
+
+// цифры с начала str до первого другого символа, по 18 за одно умножение;
+// с separators пропускаются ' (разделители в литералах)
+template<int Bits = 239>
+constexpr uint_limbs<Bits> from_decimal(const char* str, bool separators) {
+    uint_limbs<Bits> ans{};
+    uint64_t chunk = 0, scale = 1;
+    for (;; ++str) {
+        if (separators && *str == '\'') {
+            continue;
+        }
+        if (*str < '0' || *str > '9') {
+            break;
+        }
+        chunk = chunk * 10 + (*str - '0');
+        scale *= 10;
+        if (scale == kChunk) {
+            ans = mul_small(ans, scale, chunk);
+            chunk = 0;
+            scale = 1;
+        }
+    }
+    return scale > 1 ? mul_small(ans, scale, chunk) : ans;
+}
+
+} // namespace limbs
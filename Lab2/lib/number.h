@@ -7,139 +7,188 @@
 #include <cstring>
 #include <stdexcept>
 
+#include "limbs.h"
+#include "itmo_endian.h"
 
 
-struct uint239_t {
-    uint8_t data[35];
-    
-    uint239_t() {
-        for (int i = 0; i < 35; ++i) {
-            data[i] = 0;
-        }
-    }
-};
-
-template<typename T>
-class vector {
-private:
-    static const int MAX_SIZE = 700;
-    T data[MAX_SIZE];
-    int real_size;
-
-public:
-    vector() : real_size(0) {}
-
-    int size() const {
-        return real_size;
-    }
-
-    void push_back(const T &value) {
-        data[real_size++] = value;
-    }
-
-    void push_front(const T &value) {
-        for (int i = real_size; i > 0; --i) {
-            data[i] = data[i - 1];
-        }
-        data[0] = value;
-        real_size++;
-    }
-
-    T &operator[](int index) {
-
-        return data[index];
-    }
-
-    void clear() {
-        real_size = 0;
-    }
 
-    void pop_back() {
-        if (real_size > 0) {
-            --real_size;
-        }
-    }
+// Беззнаковое целое из Bits значимых бит в ITMO Endian: kBytes байт, в каждом 7 значимых бит и бит сдвига.
+// Раскладка (число байт, слов, ширина сдвига) считается при компиляции из Bits, см. limbs::layout.
+template<int Bits>
+struct uint_itmo_t {
+    uint8_t data[limbs::layout<Bits>::kBytes];
 
-    void pop_front() {
-        if (real_size > 0) {
-            for (int i = 0; i < real_size - 1; ++i) {
-                data[i] = data[i + 1];
-            }
-            --real_size;
-        }
-    }
+    constexpr uint_itmo_t() : data{} {}
+};
 
-    bool operator==(const vector &other) const {
-        if (real_size != other.real_size) {
-            return false;
-        }
-        for (size_t i = 0; i < real_size; ++i) {
-            if (data[i] != other.data[i]) {
-                return false;
-            }
-        }
-        return true;
-    }
+using uint127_t = uint_itmo_t<127>;
+using uint239_t = uint_itmo_t<239>;
+using uint511_t = uint_itmo_t<511>;
 
-    bool operator>=(const vector &other) const {
-        if (real_size > other.real_size) {
-            return true;
-        } else if (real_size < other.real_size) {
-            return false;
-        }
-
-        for (size_t i = 0; i < real_size; ++i) {
-            if (data[i] > other.data[i]) {
-                return true;
-            } else if (data[i] < other.data[i]) {
-                return false;
-            }
-        }
-        return true;
+static_assert(sizeof(uint239_t) == 35, "Size of uint239_t must be no higher than 35 bytes");
+static_assert(sizeof(uint127_t) == 19 && sizeof(uint511_t) == 73);
+
+// десятичная запись значения (без сдвига); определён в number.cpp для uint127_t, uint239_t и uint511_t
+template<int Bits>
+std::ostream &operator<<(std::ostream &stream, const uint_itmo_t<Bits> &value);
+
+// Остальное constexpr и определено здесь же: FromInt, FromString, операторы и литерал _u239
+// считаются при компиляции, если аргументы известны. Во время работы ITMO Endian у uint239_t
+// разбирается лучшим вариантом из itmo_endian.h, при компиляции и у других ширин - переносимым.
+// Сдвиг - limbs::shift_t<Bits>: uint64_t, пока служебных бит меньше 64 (у uint511_t их 73).
+
+template<int Bits>
+constexpr limbs::shift_t<Bits> GetShift(const uint_itmo_t<Bits>& value) {
+    uint_limbs<Bits> payload{};
+    limbs::shift_t<Bits> shift = 0;
+    unpack_itmo(value.data, payload, shift);
+    return shift;
+}
+
+// значение и сдвиг за один разбор
+template<int Bits>
+constexpr uint_limbs<Bits> ToLimbs(const uint_itmo_t<Bits>& value, limbs::shift_t<Bits>& shift) {
+    // значимые биты хранятся сдвинутыми по кругу влево на shift, возвращаем их обратно
+    constexpr int payload_bits = limbs::layout<Bits>::kPayloadBits;
+    uint_limbs<Bits> payload{};
+    unpack_itmo(value.data, payload, shift);
+    return limbs::rotate_left(payload, payload_bits - uint64_t(shift % payload_bits));
+}
+
+template<int Bits>
+constexpr uint_limbs<Bits> ToLimbs(const uint_itmo_t<Bits>& value) {
+    limbs::shift_t<Bits> shift = 0;
+    return ToLimbs(value, shift);
+}
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> FromLimbs(const uint_limbs<Bits>& value, limbs::shift_t<Bits> shift) {
+    shift &= limbs::layout<Bits>::kShiftMask;
+    uint_itmo_t<Bits> ans;
+    pack_itmo(ans.data, limbs::rotate_left(value, uint64_t(shift % limbs::layout<Bits>::kPayloadBits)), shift);
+    return ans;
+}
+
+template<int Bits = 239>
+constexpr uint_itmo_t<Bits> FromInt(uint32_t value, limbs::shift_t<Bits> shift) {
+    uint_limbs<Bits> bits{};
+    bits.limb[0] = value;
+    return FromLimbs(limbs::truncate(bits), shift);
+}
+
+template<int Bits = 239>
+constexpr uint_itmo_t<Bits> FromString(const char* str, limbs::shift_t<Bits> shift) {
+    return FromLimbs(limbs::from_decimal<Bits>(str, false), shift);
+}
+
+// сдвигает значимые биты по кругу влево (вправо при shift < 0), служебные биты обнуляются
+template<int Bits>
+constexpr void DoShift(uint_itmo_t<Bits>& a, int shift) {
+    constexpr int payload_bits = limbs::layout<Bits>::kPayloadBits;
+    int64_t n = shift % payload_bits;
+    if (n < 0) {
+        n += payload_bits;
     }
-
-    void erase(size_t index) {
-        for (size_t i = index; i < real_size - 1; ++i) {
-            data[i] = data[i + 1];
-        }
-        --real_size;
+    uint_limbs<Bits> payload{};
+    limbs::shift_t<Bits> old_shift = 0;
+    unpack_itmo(a.data, payload, old_shift);
+    pack_itmo(a.data, limbs::rotate_left(payload, n), 0);
+}
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> operator+(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) {
+    limbs::shift_t<Bits> ls = 0, rs = 0;
+    uint_limbs<Bits> l = ToLimbs(lhs, ls), r = ToLimbs(rhs, rs);
+    return FromLimbs(limbs::add(l, r), ls + rs);
+}
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> plus(const uint_itmo_t<Bits>& lhs1, const uint_itmo_t<Bits>& rhs1) {
+    return lhs1 + rhs1;
+}
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> operator+=(uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) {
+    lhs = lhs + rhs;
+    return lhs;
+}
+
+// сдвиги вычитаются по модулю 2^kShiftBits: беззнаковое вычитание и маска в FromLimbs
+template<int Bits>
+constexpr uint_itmo_t<Bits> operator-(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) {
+    limbs::shift_t<Bits> ls = 0, rs = 0;
+    uint_limbs<Bits> l = ToLimbs(lhs, ls), r = ToLimbs(rhs, rs);
+    return FromLimbs(limbs::sub(l, r), ls - rs);
+}
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> operator-=(uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) {
+    lhs = lhs - rhs;
+    return lhs;
+}
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> operator*(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) {
+    limbs::shift_t<Bits> ls = 0, rs = 0;
+    uint_limbs<Bits> l = ToLimbs(lhs, ls), r = ToLimbs(rhs, rs);
+    return FromLimbs(limbs::mul(l, r), ls + rs);
+}
+
+// как __builtin_mul_overflow: result = lhs * rhs по модулю 2^Bits со сдвигом как у operator*,
+// возвращает true, если настоящее произведение значений не влезло в Bits бит
+template<int Bits>
+constexpr bool mul_overflow(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs, uint_itmo_t<Bits>& result) {
+    limbs::shift_t<Bits> ls = 0, rs = 0;
+    uint_product<Bits> product = limbs::mul_full(ToLimbs(lhs, ls), ToLimbs(rhs, rs));
+    result = FromLimbs(limbs::truncate(product), ls + rs);
+    return limbs::overflows(product);
+}
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> operator/(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) {
+    limbs::shift_t<Bits> ls = 0, rs = 0;
+    uint_limbs<Bits> l = ToLimbs(lhs, ls), r = ToLimbs(rhs, rs);
+    return FromLimbs(limbs::divide(l, r), ls - rs);
+}
+
+template<int Bits>
+constexpr bool operator==(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) {
+    return limbs::compare(ToLimbs(lhs), ToLimbs(rhs)) == 0;
+}
+
+template<int Bits>
+constexpr bool operator!=(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) { return (!(lhs == rhs)); }
+
+template<int Bits>
+constexpr bool operator>(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) {
+    return limbs::compare(ToLimbs(lhs), ToLimbs(rhs)) > 0;
+}
+
+template<int Bits>
+constexpr bool operator<(const uint_itmo_t<Bits>& lhs, const uint_itmo_t<Bits>& rhs) { return rhs > lhs; }
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> SetShift(const uint_itmo_t<Bits> num, limbs::shift_t<Bits> shift) {
+    return FromLimbs(ToLimbs(num), shift);
+}
+
+template<int Bits>
+constexpr uint_itmo_t<Bits> ClearShift(const uint_itmo_t<Bits> num) {
+    uint_itmo_t<Bits> ans = num;
+
+    for (uint8_t& byte : ans.data) {
+        byte &= 0x7f;
     }
-
-    friend void my_reverse(vector<char> &str, int shift);
-
-    friend uint239_t FromString(const char *str, uint32_t shift);
-
-    friend std::ostream &operator<<(std::ostream &stream, const uint239_t &value);
-};
-
-static_assert(sizeof(uint239_t) == 35, "Size of uint239_t must be no higher than 35 bytes");
-
-uint239_t build_new_239(vector<char> &str, long long shift);
-vector<char> get_sum_str_for_mul(vector<char> a, vector<char> b);
-vector<char> get_multi_str(vector<char> a, vector<char> b);
-vector<char> get_sum_str(vector<char> a, vector<char> b);
-vector<char> get_minus_str_for_div(vector<char> a, vector<char> b);
-vector<char> division(vector<char> &dividend, vector<char> &divisor);
-vector<char> get_minus_str(vector<char> a,vector<char> b);
-void my_reverse(vector<char> &str, int shift);
-vector<char> get_str_from_239(uint239_t a);
-uint239_t operator+( const uint239_t &lhs,const   uint239_t &rhs);
-uint239_t operator-(const uint239_t &aa, const uint239_t &bb);
-uint239_t operator*(const uint239_t &aa, const uint239_t &bb);
-uint239_t operator/(const uint239_t &aa, const uint239_t &bb);
-bool operator==(const uint239_t &a, const uint239_t &b);
-bool operator!=(const uint239_t &a, const uint239_t &b);
-std::ostream &operator<<(std::ostream &stream, const uint239_t &value);
-uint64_t GetShift(const uint239_t &value);
-uint239_t operator+=( uint239_t &lhs, const uint239_t &rhs);
-uint239_t operator-=( uint239_t& lhs, const uint239_t& rhs);
-void my_reverse2(uint239_t &strr, int shift);
-uint239_t SetShift(const uint239_t num, uint64_t shift);
-uint239_t FromInt(uint32_t value, uint64_t shift);
-uint239_t FromString(const char* str, uint64_t shift);
-uint8_t len(const uint239_t& num);
-uint239_t ClearShift(const uint239_t num);
-bool operator<(const uint239_t& lhs, const uint239_t& rhs);
-bool operator>(const uint239_t& lhs, const uint239_t& rhs);
-void DoShift(uint239_t& a, int shift);
-uint239_t plus( const uint239_t& lhs1,  const uint239_t& rhs1);
\ No newline at end of file
+    return ans;
+}
+
+template<int Bits>
+constexpr int len(const uint_itmo_t<Bits>& num) {
+    return limbs::bit_length(ToLimbs(num));
+}
+
+// 123456789012345678901234567890_u239: число любой длины со сдвигом 0, собирается при компиляции.
+// Разделители цифр (1'000'000_u239) пропускаются.
+consteval uint239_t operator""_u239(const char* str) {
+    return FromLimbs(limbs::from_decimal(str, true), 0);
+}
@@ -0,0 +1,185 @@
+#include "uint239_array.h"
+
+#ifdef NUMBER_AVX2
+void add_avx2(const uint239_array& a, const uint239_array& b, uint239_array& out);
+void sub_avx2(const uint239_array& a, const uint239_array& b, uint239_array& out);
+size_t compare_avx2(const uint239_array& a, const uint239_array& b, int8_t* result);
+void do_shift_avx2(uint239_array& a, int shift);
+void load_avx2(uint239_array& a, const uint239_t* values);
+void store_avx2(const uint239_array& a, uint239_t* values);
+#endif
+
+namespace {
+
+uint239_limbs read(const uint239_array& a, size_t i) {
+    return uint239_limbs{{a.limb(0)[i], a.limb(1)[i], a.limb(2)[i], a.limb(3)[i]}};
+}
+
+void write(uint239_array& a, size_t i, const uint239_limbs& value, uint64_t shift) {
+    for (int k = 0; k < 4; ++k) {
+        a.limb(k)[i] = value.limb[k];
+    }
+    a.shifts()[i] = shift % limbs::kShiftModulo;
+}
+
+void add_scalar(const uint239_array& a, const uint239_array& b, uint239_array& out) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        write(out, i, limbs::add(read(a, i), read(b, i)), a.shifts()[i] + b.shifts()[i]);
+    }
+}
+
+void sub_scalar(const uint239_array& a, const uint239_array& b, uint239_array& out) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        write(out, i, limbs::sub(read(a, i), read(b, i)), a.shifts()[i] + limbs::kShiftModulo - b.shifts()[i]);
+    }
+}
+
+void compare_scalar(const uint239_array& a, const uint239_array& b, int8_t* result, size_t from = 0) {
+    for (size_t i = from; i < a.size(); ++i) {
+        result[i] = limbs::compare(read(a, i), read(b, i));
+    }
+}
+
+// значение без сдвига v со сдвигом s хранится как rotl(v, s); DoShift поворачивает ещё на shift
+// и обнуляет сдвиг, то есть новое значение - rotl(v, s + shift)
+void do_shift_scalar(uint239_array& a, int shift) {
+    int64_t n = shift % limbs::kPayloadBits;
+    if (n < 0) {
+        n += limbs::kPayloadBits;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        write(a, i, limbs::rotate_left(read(a, i), a.shifts()[i] % limbs::kPayloadBits + n), 0);
+    }
+}
+
+void load_scalar(uint239_array& a, const uint239_t* values) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        a.set(i, values[i]);
+    }
+}
+
+void store_scalar(const uint239_array& a, uint239_t* values) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        values[i] = a.get(i);
+    }
+}
+
+} // namespace
+
+uint239_array::uint239_array(size_t size)
+    : length(size), padded((size + kLanes - 1) / kLanes * kLanes), memory(new uint64_t[5 * padded]()) {}
+
+uint239_array::~uint239_array() {
+    delete[] memory;
+}
+
+uint239_t uint239_array::get(size_t i) const {
+    return FromLimbs(read(*this, i), shifts()[i]);
+}
+
+void uint239_array::set(size_t i, const uint239_t& value) {
+    write(*this, i, ToLimbs(value), GetShift(value));
+}
+
+void uint239_array::load(const uint239_t* values) {
+    static const ArrayKind kind = best_array_kind();
+    ::load(*this, values, kind);
+}
+
+void uint239_array::store(uint239_t* values) const {
+    static const ArrayKind kind = best_array_kind();
+    ::store(*this, values, kind);
+}
+
+ArrayKind best_array_kind() {
+#ifdef NUMBER_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return ArrayKind::Avx2;
+    }
+#endif
+    return ArrayKind::Scalar;
+}
+
+const char* array_kind_name(ArrayKind kind) {
+    return kind == ArrayKind::Avx2 ? "avx2" : "scalar";
+}
+
+void add(const uint239_array& a, const uint239_array& b, uint239_array& out, ArrayKind kind) {
+#ifdef NUMBER_AVX2
+    if (kind == ArrayKind::Avx2) {
+        add_avx2(a, b, out);
+        return;
+    }
+#endif
+    add_scalar(a, b, out);
+}
+
+void sub(const uint239_array& a, const uint239_array& b, uint239_array& out, ArrayKind kind) {
+#ifdef NUMBER_AVX2
+    if (kind == ArrayKind::Avx2) {
+        sub_avx2(a, b, out);
+        return;
+    }
+#endif
+    sub_scalar(a, b, out);
+}
+
+void compare(const uint239_array& a, const uint239_array& b, int8_t* result, ArrayKind kind) {
+#ifdef NUMBER_AVX2
+    if (kind == ArrayKind::Avx2) {
+        compare_scalar(a, b, result, compare_avx2(a, b, result));
+        return;
+    }
+#endif
+    compare_scalar(a, b, result);
+}
+
+void do_shift(uint239_array& a, int shift, ArrayKind kind) {
+#ifdef NUMBER_AVX2
+    if (kind == ArrayKind::Avx2) {
+        do_shift_avx2(a, shift);
+        return;
+    }
+#endif
+    do_shift_scalar(a, shift);
+}
+
+void load(uint239_array& a, const uint239_t* values, ArrayKind kind) {
+#ifdef NUMBER_AVX2
+    if (kind == ArrayKind::Avx2) {
+        load_avx2(a, values);
+        return;
+    }
+#endif
+    load_scalar(a, values);
+}
+
+void store(const uint239_array& a, uint239_t* values, ArrayKind kind) {
+#ifdef NUMBER_AVX2
+    if (kind == ArrayKind::Avx2) {
+        store_avx2(a, values);
+        return;
+    }
+#endif
+    store_scalar(a, values);
+}
+
+void add(const uint239_array& a, const uint239_array& b, uint239_array& out) {
+    static const ArrayKind kind = best_array_kind();
+    add(a, b, out, kind);
+}
+
+void sub(const uint239_array& a, const uint239_array& b, uint239_array& out) {
+    static const ArrayKind kind = best_array_kind();
+    sub(a, b, out, kind);
+}
+
+void compare(const uint239_array& a, const uint239_array& b, int8_t* result) {
+    static const ArrayKind kind = best_array_kind();
+    compare(a, b, result, kind);
+}
+
+void do_shift(uint239_array& a, int shift) {
+    static const ArrayKind kind = best_array_kind();
+    do_shift(a, shift, kind);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+
+#include "number.h"
+
+// Много uint239_t сразу в виде структуры массивов: k-е слова всех значений лежат подряд
+// (limb(k)[i]), сдвиги - отдельным массивом. Значения хранятся уже без сдвига, как в ToLimbs,
+// поэтому add/sub/compare/do_shift идут по 4 числа за раз в регистрах AVX2 (если он есть),
+// а ITMO Endian разбирается только в load/store.
+// Память своя (std контейнеры в библиотеке не используются), размер округляется вверх до 4,
+// хвост заполнен нулями.
+class uint239_array {
+public:
+    static constexpr size_t kLanes = 4;
+
+    explicit uint239_array(size_t size);
+    ~uint239_array();
+
+    uint239_array(const uint239_array&) = delete;
+    uint239_array& operator=(const uint239_array&) = delete;
+
+    size_t size() const {
+        return length;
+    }
+
+    // size(), округлённый до kLanes: столько обрабатывают ядра
+    size_t padded_size() const {
+        return padded;
+    }
+
+    uint64_t* limb(int k) {
+        return memory + k * padded;
+    }
+
+    const uint64_t* limb(int k) const {
+        return memory + k * padded;
+    }
+
+    uint64_t* shifts() {
+        return memory + 4 * padded;
+    }
+
+    const uint64_t* shifts() const {
+        return memory + 4 * padded;
+    }
+
+    uint239_t get(size_t i) const;
+    void set(size_t i, const uint239_t& value);
+
+    // из size() чисел в ITMO Endian подряд (35 байт каждое) и обратно
+    void load(const uint239_t* values);
+    void store(uint239_t* values) const;
+
+private:
+    size_t length;
+    size_t padded;
+    uint64_t* memory;
+};
+
+enum class ArrayKind {
+    Scalar,
+    Avx2,
+};
+
+ArrayKind best_array_kind();
+const char* array_kind_name(ArrayKind kind);
+
+// Поэлементно, как у uint239_t: out[i] = a[i] + b[i] (сдвиги складываются), out[i] = a[i] - b[i]
+// (сдвиги вычитаются). Все массивы одного размера, out может совпадать с a или b.
+void add(const uint239_array& a, const uint239_array& b, uint239_array& out, ArrayKind kind);
+void sub(const uint239_array& a, const uint239_array& b, uint239_array& out, ArrayKind kind);
+// result[i] = -1, 0 или 1 по значениям, сдвиг не учитывается
+void compare(const uint239_array& a, const uint239_array& b, int8_t* result, ArrayKind kind);
+// DoShift(a[i], shift) для каждого числа
+void do_shift(uint239_array& a, int shift, ArrayKind kind);
+
+void load(uint239_array& a, const uint239_t* values, ArrayKind kind);
+void store(const uint239_array& a, uint239_t* values, ArrayKind kind);
+
+// то же самое лучшим доступным способом
+void add(const uint239_array& a, const uint239_array& b, uint239_array& out);
+void sub(const uint239_array& a, const uint239_array& b, uint239_array& out);
+void compare(const uint239_array& a, const uint239_array& b, int8_t* result);
+void do_shift(uint239_array& a, int shift);
@@ -0,0 +1,296 @@
+// собирается с -mavx2, вызывается только если процессор поддерживает AVX2.
+// Арифметика из limbs.h и number.h здесь не вызывается: её inline копия, собранная с AVX2,
+// могла бы достаться при линковке и остальному коду. Хвосты досчитываются в uint239_array.cpp.
+#include "uint239_array.h"
+
+#include <cstring>
+
+#include <immintrin.h>
+
+using namespace itmo_endian;
+
+namespace {
+
+// в регистре 4 числа: k-е слово каждого из них
+using Lanes = __m256i;
+
+Lanes load_lanes(const uint64_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+void store_lanes(uint64_t* p, Lanes v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+Lanes set1(uint64_t x) {
+    return _mm256_set1_epi64x(x);
+}
+
+// маска a < b без знака: сравнение со знаком после сдвига диапазона на 2^63
+Lanes less(Lanes a, Lanes b) {
+    Lanes sign = set1(1ull << 63);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+}
+
+Lanes compress7(Lanes x) {
+    x = _mm256_and_si256(x, set1(kLowBits));
+    x = _mm256_or_si256(_mm256_and_si256(x, set1(0x007f007f007f007full)),
+                        _mm256_and_si256(_mm256_srli_epi64(x, 1), set1(0x3f803f803f803f80ull)));
+    x = _mm256_or_si256(_mm256_and_si256(x, set1(0x00003fff00003fffull)),
+                        _mm256_and_si256(_mm256_srli_epi64(x, 2), set1(0x0fffc0000fffc000ull)));
+    x = _mm256_or_si256(_mm256_and_si256(x, set1(0x000000000fffffffull)),
+                        _mm256_and_si256(_mm256_srli_epi64(x, 4), set1(0x00fffffff0000000ull)));
+    return x;
+}
+
+Lanes expand7(Lanes x) {
+    x = _mm256_and_si256(x, set1(kGroupMask));
+    x = _mm256_or_si256(_mm256_and_si256(x, set1(0x000000000fffffffull)),
+                        _mm256_and_si256(_mm256_slli_epi64(x, 4), set1(0x0fffffff00000000ull)));
+    x = _mm256_or_si256(_mm256_and_si256(x, set1(0x00003fff00003fffull)),
+                        _mm256_and_si256(_mm256_slli_epi64(x, 2), set1(0x3fff00003fff0000ull)));
+    x = _mm256_or_si256(_mm256_and_si256(x, set1(0x007f007f007f007full)),
+                        _mm256_and_si256(_mm256_slli_epi64(x, 1), set1(0x7f007f007f007f00ull)));
+    return x;
+}
+
+Lanes scatter_high(Lanes x) {
+    x = _mm256_and_si256(x, set1(0xff));
+    x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 28)), set1(0x0000000f0000000full));
+    x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 14)), set1(0x0003000300030003ull));
+    x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 7)), set1(0x0101010101010101ull));
+    return _mm256_slli_epi64(x, 7);
+}
+
+// сдвиги 4 чисел на разное для каждого n < 256 бит. vpsllvq/vpsrlvq дают 0 при сдвиге на 64,
+// поэтому при n кратном 64 соседнее слово само обнуляется
+void shift_left(const Lanes* v, Lanes n, Lanes* out) {
+    Lanes words = _mm256_srli_epi64(n, 6);
+    Lanes bits = _mm256_and_si256(n, set1(63));
+    Lanes back = _mm256_sub_epi64(set1(64), bits);
+    for (int i = 0; i < 4; ++i) {
+        Lanes acc = _mm256_setzero_si256();
+        for (int w = 0; w <= i; ++w) {
+            Lanes part = _mm256_sllv_epi64(v[i - w], bits);
+            if (i - w > 0) {
+                part = _mm256_or_si256(part, _mm256_srlv_epi64(v[i - w - 1], back));
+            }
+            acc = _mm256_or_si256(acc, _mm256_and_si256(_mm256_cmpeq_epi64(words, set1(w)), part));
+        }
+        out[i] = acc;
+    }
+}
+
+void shift_right(const Lanes* v, Lanes n, Lanes* out) {
+    Lanes words = _mm256_srli_epi64(n, 6);
+    Lanes bits = _mm256_and_si256(n, set1(63));
+    Lanes back = _mm256_sub_epi64(set1(64), bits);
+    for (int i = 0; i < 4; ++i) {
+        Lanes acc = _mm256_setzero_si256();
+        for (int w = 0; i + w < 4; ++w) {
+            Lanes part = _mm256_srlv_epi64(v[i + w], bits);
+            if (i + w < 3) {
+                part = _mm256_or_si256(part, _mm256_sllv_epi64(v[i + w + 1], back));
+            }
+            acc = _mm256_or_si256(acc, _mm256_and_si256(_mm256_cmpeq_epi64(words, set1(w)), part));
+        }
+        out[i] = acc;
+    }
+}
+
+// циклический сдвиг 245 бит влево, 0 <= n < 245 у каждого числа своё
+void rotate_left(Lanes* v, Lanes n) {
+    Lanes l[4], r[4];
+    shift_left(v, n, l);
+    shift_right(v, _mm256_sub_epi64(set1(limbs::kPayloadBits), n), r);
+    for (int k = 0; k < 4; ++k) {
+        v[k] = _mm256_or_si256(l[k], r[k]);
+    }
+    v[3] = _mm256_and_si256(v[3], set1(limbs::kPayloadTop));
+}
+
+// сдвиг по модулю 245 у 4 чисел; деление по одному, векторного деления на 64 бита нет
+Lanes rotation(const uint64_t* shifts, int64_t extra) {
+    uint64_t n[4];
+    for (int j = 0; j < 4; ++j) {
+        n[j] = (shifts[j] % limbs::kPayloadBits + extra) % limbs::kPayloadBits;
+    }
+    return load_lanes(n);
+}
+
+uint64_t load_big_endian(const uint8_t* p) {
+    uint64_t word;
+    memcpy(&word, p, 8);
+    return __builtin_bswap64(word);
+}
+
+void store_big_endian(uint8_t* p, uint64_t word) {
+    word = __builtin_bswap64(word);
+    memcpy(p, &word, 8);
+}
+
+} // namespace
+
+void add_avx2(const uint239_array& a, const uint239_array& b, uint239_array& out) {
+    for (size_t i = 0; i < a.padded_size(); i += 4) {
+        Lanes carry = _mm256_setzero_si256();
+        for (int k = 0; k < 4; ++k) {
+            Lanes x = load_lanes(a.limb(k) + i);
+            Lanes sum = _mm256_add_epi64(x, load_lanes(b.limb(k) + i));
+            Lanes total = _mm256_add_epi64(sum, carry);
+            carry = _mm256_srli_epi64(_mm256_or_si256(less(sum, x), less(total, sum)), 63);
+            if (k == 3) {
+                total = _mm256_and_si256(total, set1(limbs::kValueTop));
+            }
+            store_lanes(out.limb(k) + i, total);
+        }
+        Lanes shift = _mm256_add_epi64(load_lanes(a.shifts() + i), load_lanes(b.shifts() + i));
+        store_lanes(out.shifts() + i, _mm256_and_si256(shift, set1(limbs::kShiftModulo - 1)));
+    }
+}
+
+void sub_avx2(const uint239_array& a, const uint239_array& b, uint239_array& out) {
+    for (size_t i = 0; i < a.padded_size(); i += 4) {
+        Lanes borrow = _mm256_setzero_si256();
+        for (int k = 0; k < 4; ++k) {
+            Lanes x = load_lanes(a.limb(k) + i);
+            Lanes y = load_lanes(b.limb(k) + i);
+            Lanes diff = _mm256_sub_epi64(x, y);
+            Lanes total = _mm256_sub_epi64(diff, borrow);
+            borrow = _mm256_srli_epi64(_mm256_or_si256(less(x, y), less(diff, borrow)), 63);
+            if (k == 3) {
+                total = _mm256_and_si256(total, set1(limbs::kValueTop));
+            }
+            store_lanes(out.limb(k) + i, total);
+        }
+        Lanes shift = _mm256_sub_epi64(load_lanes(a.shifts() + i), load_lanes(b.shifts() + i));
+        store_lanes(out.shifts() + i, _mm256_and_si256(shift, set1(limbs::kShiftModulo - 1)));
+    }
+}
+
+// только полные четвёрки, возвращает, сколько сравнено; остаток досчитывает вызывающий
+size_t compare_avx2(const uint239_array& a, const uint239_array& b, int8_t* result) {
+    size_t i = 0;
+    for (; i + 4 <= a.size(); i += 4) {
+        Lanes lt = _mm256_setzero_si256();
+        Lanes gt = _mm256_setzero_si256();
+        Lanes eq = set1(~0ull);
+        for (int k = 3; k >= 0; --k) {
+            Lanes x = load_lanes(a.limb(k) + i);
+            Lanes y = load_lanes(b.limb(k) + i);
+            lt = _mm256_or_si256(lt, _mm256_and_si256(eq, less(x, y)));
+            gt = _mm256_or_si256(gt, _mm256_and_si256(eq, less(y, x)));
+            eq = _mm256_and_si256(eq, _mm256_cmpeq_epi64(x, y));
+        }
+        int less_bits = _mm256_movemask_pd(_mm256_castsi256_pd(lt));
+        int greater_bits = _mm256_movemask_pd(_mm256_castsi256_pd(gt));
+        for (int j = 0; j < 4; ++j) {
+            result[i + j] = ((greater_bits >> j) & 1) - ((less_bits >> j) & 1);
+        }
+    }
+    return i;
+}
+
+void do_shift_avx2(uint239_array& a, int shift) {
+    int64_t extra = shift % limbs::kPayloadBits;
+    if (extra < 0) {
+        extra += limbs::kPayloadBits;
+    }
+    for (size_t i = 0; i < a.padded_size(); i += 4) {
+        Lanes v[4];
+        for (int k = 0; k < 4; ++k) {
+            v[k] = load_lanes(a.limb(k) + i);
+        }
+        rotate_left(v, rotation(a.shifts() + i, extra));
+        for (int k = 0; k < 4; ++k) {
+            store_lanes(a.limb(k) + i, v[k]);
+        }
+        store_lanes(a.shifts() + i, _mm256_setzero_si256());
+    }
+}
+
+// 4 числа за раз: группы по 8 байт всех четырёх в одном регистре
+void load_avx2(uint239_array& a, const uint239_t* values) {
+    size_t i = 0;
+    for (; i + 4 <= a.size(); i += 4) {
+        Lanes part[5];
+        uint64_t shift[4] = {};
+        for (int g = 0; g < 5; ++g) {
+            // хвост data[0..2] читается вместе с data[3..7] и сдвигается вниз
+            int start = g < 4 ? kGroupStart[g] : 0;
+            uint64_t words[4];
+            for (int j = 0; j < 4; ++j) {
+                words[j] = load_big_endian(values[i + j].data + start);
+            }
+            Lanes word = load_lanes(words);
+            if (g == 4) {
+                word = _mm256_srli_epi64(word, 40);
+            }
+            part[g] = compress7(word);
+            // старшие биты байтов: по 8 на число, младший байт слова - младший бит
+            uint32_t high = _mm256_movemask_epi8(word);
+            for (int j = 0; j < 4; ++j) {
+                shift[j] |= uint64_t((high >> (8 * j)) & 0xff) << (8 * g);
+            }
+        }
+        Lanes v[4] = {
+            _mm256_or_si256(part[0], _mm256_slli_epi64(part[1], 56)),
+            _mm256_or_si256(_mm256_srli_epi64(part[1], 8), _mm256_slli_epi64(part[2], 48)),
+            _mm256_or_si256(_mm256_srli_epi64(part[2], 16), _mm256_slli_epi64(part[3], 40)),
+            _mm256_or_si256(_mm256_srli_epi64(part[3], 24), _mm256_slli_epi64(part[4], 32)),
+        };
+        // как в ToLimbs: нагрузка повёрнута влево на shift, возвращаем
+        uint64_t back[4];
+        for (int j = 0; j < 4; ++j) {
+            back[j] = (limbs::kPayloadBits - shift[j] % limbs::kPayloadBits) % limbs::kPayloadBits;
+        }
+        rotate_left(v, load_lanes(back));
+        for (int k = 0; k < 4; ++k) {
+            store_lanes(a.limb(k) + i, v[k]);
+        }
+        store_lanes(a.shifts() + i, load_lanes(shift));
+    }
+    for (; i < a.size(); ++i) {
+        a.set(i, values[i]);
+    }
+}
+
+void store_avx2(const uint239_array& a, uint239_t* values) {
+    size_t i = 0;
+    for (; i + 4 <= a.size(); i += 4) {
+        Lanes v[4];
+        for (int k = 0; k < 4; ++k) {
+            v[k] = load_lanes(a.limb(k) + i);
+        }
+        Lanes shift = load_lanes(a.shifts() + i);
+        rotate_left(v, rotation(a.shifts() + i, 0));
+        Lanes mask = set1(kGroupMask);
+        Lanes part[5] = {
+            _mm256_and_si256(v[0], mask),
+            _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(v[0], 56), _mm256_slli_epi64(v[1], 8)), mask),
+            _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(v[1], 48), _mm256_slli_epi64(v[2], 16)), mask),
+            _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(v[2], 40), _mm256_slli_epi64(v[3], 24)), mask),
+            _mm256_and_si256(_mm256_srli_epi64(v[3], 32), set1(0x1fffff)),
+        };
+        for (int g = 0; g < 5; ++g) {
+            Lanes high = _mm256_srlv_epi64(shift, set1(8 * g));
+            if (g == 4) {
+                high = _mm256_and_si256(high, set1(0x7));
+            }
+            uint64_t words[4];
+            store_lanes(words, _mm256_or_si256(expand7(part[g]), scatter_high(high)));
+            for (int j = 0; j < 4; ++j) {
+                if (g < 4) {
+                    store_big_endian(values[i + j].data + kGroupStart[g], words[j]);
+                } else {
+                    values[i + j].data[0] = words[j] >> 16;
+                    values[i + j].data[1] = words[j] >> 8;
+                    values[i + j].data[2] = words[j];
+                }
+            }
+        }
+    }
+    for (; i < a.size(); ++i) {
+        values[i] = a.get(i);
+    }
+}
@@ -0,0 +1,85 @@
+#include <lib/accumulator.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "test_random.h"
+
+static_assert((uint239_accumulator(FromInt(1000, 3)) + FromInt(24, 4)).get() == FromInt(1024, 7));
+static_assert(GetShift((uint239_accumulator(FromInt(1, 3)) - FromInt(1, 4)).get()) == 34359738367ull);
+static_assert((uint239_accumulator(FromInt(65536, 1)) * FromInt(65536, 2)).get() == 4294967296_u239);
+static_assert((uint239_accumulator(FromInt(65536, 1)) * FromInt(65536, 2)).get_shift() == 3);
+
+
+namespace {
+
+void expect_same(const uint239_t& a, const uint239_t& b) {
+    ASSERT_EQ(memcmp(a.data, b.data, 35), 0);
+}
+
+} // namespace
+
+
+// байт в байт то же, что цепочка операторов
+TEST(AccumulatorTest, MatchesOperatorChain) {
+    std::vector<uint239_t> numbers = random_numbers(3000, 239);
+    uint239_accumulator sum(numbers[0]), mixed(numbers[0]);
+    uint239_t expected_sum = numbers[0], expected_mixed = numbers[0];
+    for (size_t i = 1; i < numbers.size(); ++i) {
+        sum += numbers[i];
+        expected_sum = expected_sum + numbers[i];
+        switch (i % 3) {
+            case 0:
+                mixed += numbers[i];
+                expected_mixed = expected_mixed + numbers[i];
+                break;
+            case 1:
+                mixed -= numbers[i];
+                expected_mixed = expected_mixed - numbers[i];
+                break;
+            default:
+                mixed *= numbers[i];
+                expected_mixed = expected_mixed * numbers[i];
+                break;
+        }
+        expect_same(sum, expected_sum);
+        expect_same(mixed, expected_mixed);
+        ASSERT_EQ(sum.get_shift(), GetShift(expected_sum));
+    }
+}
+
+TEST(AccumulatorTest, PartialSums) {
+    std::vector<uint239_t> numbers = random_numbers(1000, 30);
+    uint239_accumulator left, right;
+    uint239_t expected = FromInt(0, 0);
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        (i < numbers.size() / 2 ? left : right) += numbers[i];
+        expected = expected + numbers[i];
+    }
+    left += right;
+    expect_same(left.get(), expected);
+}
+
+TEST(AccumulatorTest, ExpressionChain) {
+    std::vector<uint239_t> n = random_numbers(5, 7);
+    // обычный приоритет: n[2] * n[3] считается отдельно, до аккумулятора
+    uint239_t fused = uint239_accumulator(n[0]) + n[1] - n[2] * n[3];
+    expect_same(fused, n[0] + n[1] - n[2] * n[3]);
+    uint239_accumulator product(n[0]);
+    product *= n[1];
+    product -= n[2];
+    expect_same(product, n[0] * n[1] - n[2]);
+    uint239_t sum = uint239_accumulator(n[0]) + n[1] + n[2] + n[3] + n[4];
+    expect_same(sum, n[0] + n[1] + n[2] + n[3] + n[4]);
+}
+
+TEST(AccumulatorTest, OtherWidths) {
+    uint_itmo_accumulator<511> total;
+    uint511_t expected = FromInt<511>(0, 0);
+    for (uint32_t i = 1; i <= 100; ++i) {
+        total += FromInt<511>(i, (unsigned __int128) i << 70);
+        expected = expected + FromInt<511>(i, (unsigned __int128) i << 70);
+    }
+    ASSERT_EQ(total.get(), expected);
+    ASSERT_TRUE(GetShift(total.get()) == GetShift(expected));
+}
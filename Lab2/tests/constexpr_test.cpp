@@ -0,0 +1,48 @@
+#include <lib/number.h>
+#include <gtest/gtest.h>
+
+
+// проверки, которые выполняются компилятором: если что-то сломано, тесты не соберутся
+
+static_assert(FromInt(239, 0) == FromString("239", 0));
+static_assert(FromInt(239, 5) == 239_u239);
+static_assert(GetShift(FromInt(239, 77)) == 77);
+static_assert(GetShift(FromInt(1, 34359738368ull + 3)) == 3);
+static_assert(1'000'000_u239 == FromInt(1000000, 0));
+
+static_assert(FromInt(1000, 0) + FromInt(24, 0) == 1024_u239);
+static_assert(GetShift(FromInt(1, 3) + FromInt(1, 4)) == 7);
+static_assert(FromInt(1024, 0) - FromInt(24, 0) == 1000_u239);
+static_assert(GetShift(FromInt(1, 3) - FromInt(1, 4)) == 34359738367ull);
+static_assert(FromInt(65536, 0) * FromInt(65536, 0) == 4294967296_u239);
+static_assert(4294967296_u239 / FromInt(65536, 0) == FromInt(65536, 0));
+static_assert(FromInt(1, 0) < FromInt(2, 0) && FromInt(3, 0) > FromInt(2, 0));
+static_assert(FromInt(1, 0) != FromInt(2, 0));
+
+// 2^238 и 2^239 - 1, по модулю 2^239
+static_assert(len(441711766194596082395824375185729628956870974218904739530401550323154944_u239) == 239);
+static_assert(883423532389192164791648750371459257913741948437809479060803100646309887_u239 + 1_u239 == 0_u239);
+static_assert(0_u239 - 1_u239 == 883423532389192164791648750371459257913741948437809479060803100646309887_u239);
+static_assert(len(0_u239) == 0);
+
+// ClearShift только обнуляет служебные биты: при сдвиге, кратном 245, значение не меняется
+static_assert(ClearShift(FromInt(7, 245 * 3)) == FromInt(7, 0));
+static_assert(GetShift(ClearShift(FromInt(7, 12345))) == 0);
+static_assert(SetShift(777777777777777777_u239, 77) == FromString("777777777777777777", 77));
+static_assert(GetShift(SetShift(777777777777777777_u239, 77)) == 77);
+
+constexpr uint239_t kShifted = [] {
+    uint239_t a = FromInt(7, 0);
+    DoShift(a, 1);
+    return a;
+}();
+static_assert(kShifted == FromInt(14, 0));
+
+
+// те же значения во время работы собираются другим (лучшим доступным) кодеком и должны совпасть побайтно
+TEST(ConstexprTest, SameBytesAtRuntime) {
+    constexpr uint239_t compiled = 777777777777777777_u239 * FromInt(239, 77);
+    volatile uint32_t factor = 239;
+    uint239_t runtime = FromString("777777777777777777", 0) * FromInt(factor, 77);
+    ASSERT_EQ(memcmp(compiled.data, runtime.data, 35), 0);
+}
@@ -0,0 +1,66 @@
+#include <lib/number.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "test_random.h"
+
+
+namespace {
+
+std::string to_string(const uint239_t& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+} // namespace
+
+
+TEST(DecimalTest, PrintKnownValues) {
+    ASSERT_EQ(to_string(FromInt(0, 0)), "0");
+    ASSERT_EQ(to_string(FromInt(239, 17)), "239");
+    ASSERT_EQ(to_string(FromString("1000000000000000000", 3)), "1000000000000000000");
+    ASSERT_EQ(to_string(FromString("999999999999999999999999999999999999", 1)), "999999999999999999999999999999999999");
+    ASSERT_EQ(to_string(FromInt(0, 0) - FromInt(1, 0)),
+              "883423532389192164791648750371459257913741948437809479060803100646309887");
+}
+
+TEST(DecimalTest, RoundTrip) {
+    TestRandom random(239);
+    for (int t = 0; t < 20000; ++t) {
+        uint239_t a = FromLimbs(random.next_limbs(1 + t % 4), t * 7919);
+        uint239_t b = FromString(to_string(a).c_str(), GetShift(a));
+        ASSERT_EQ(memcmp(a.data, b.data, 35), 0) << to_string(a);
+    }
+}
+
+// q = a / b должно давать a = q * b + r, 0 <= r < b, на делителях любой длины:
+// при слишком большом q разность a - q * b уходит через 0 и становится огромной
+TEST(DecimalTest, DivisionIdentity) {
+    TestRandom random(30);
+    for (int t = 0; t < 20000; ++t) {
+        uint239_t a = FromLimbs(random.next_limbs(1 + t % 4), 0);
+        uint239_t b = FromLimbs(random.next_limbs(1 + (t / 4) % 4), 0);
+        if (t % 7 == 0) {
+            b = FromLimbs(uint239_limbs{{0, 0, ~0ull, ToLimbs(a).limb[3]}}, 0);
+        }
+        if (b == FromInt(0, 0)) {
+            continue;
+        }
+        uint239_t q = a / b;
+        uint239_t r = a - q * b;
+        ASSERT_TRUE(r < b) << to_string(a) << " / " << to_string(b) << " = " << to_string(q);
+    }
+}
+
+TEST(DecimalTest, DivisionByZero) {
+    ASSERT_THROW(FromInt(1, 0) / FromInt(0, 0), std::domain_error);
+}
+
+// после DoShift значение занимает все 245 бит, а это 74 цифры - больше, чем влезает в 239 бит
+TEST(DecimalTest, PrintFullPayload) {
+    uint239_t a = FromInt(1, 0);
+    DoShift(a, 244);
+    ASSERT_EQ(to_string(a), "28269553036454149273332760011886696253239742350009903329945699220681916416");
+}
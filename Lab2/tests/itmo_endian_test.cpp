@@ -0,0 +1,108 @@
+#include <lib/itmo_endian.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "test_random.h"
+
+
+namespace {
+
+// разбор по одному биту, как он описан в условии: с ним сравниваются оба варианта кодека
+void unpack_reference(const uint8_t* data, uint239_limbs& payload, uint64_t& shift) {
+    payload = uint239_limbs{{0, 0, 0, 0}};
+    shift = 0;
+    for (int i = 0; i < 35; ++i) {
+        shift = (shift << 1) | (data[i] >> 7);
+        for (int j = 0; j < 7; ++j) {
+            int bit = 7 * (34 - i) + j;
+            payload.limb[bit / 64] |= uint64_t((data[i] >> j) & 1) << (bit % 64);
+        }
+    }
+}
+
+std::vector<CodecKind> codecs() {
+    std::vector<CodecKind> kinds = {CodecKind::Portable};
+    if (best_codec() == CodecKind::Bmi2) {
+        kinds.push_back(CodecKind::Bmi2);
+    }
+    return kinds;
+}
+
+void check_round_trip(const uint8_t* data) {
+    uint239_limbs expected;
+    uint64_t expected_shift;
+    unpack_reference(data, expected, expected_shift);
+    for (CodecKind kind : codecs()) {
+        uint239_limbs payload;
+        uint64_t shift;
+        unpack_itmo(data, payload, shift, kind);
+        ASSERT_EQ(shift, expected_shift) << codec_name(kind);
+        for (int k = 0; k < 4; ++k) {
+            ASSERT_EQ(payload.limb[k], expected.limb[k]) << codec_name(kind) << " limb " << k;
+        }
+
+        uint8_t packed[35];
+        memset(packed, 0xa5, sizeof(packed));
+        pack_itmo(packed, payload, shift, kind);
+        ASSERT_EQ(memcmp(packed, data, 35), 0) << codec_name(kind);
+    }
+}
+
+} // namespace
+
+
+// каждый байт на каждой позиции, остальные байты нули
+TEST(ItmoEndianTest, EveryByteAtEveryPosition) {
+    for (int i = 0; i < 35; ++i) {
+        for (int value = 0; value < 256; ++value) {
+            uint8_t data[35] = {};
+            data[i] = value;
+            check_round_trip(data);
+        }
+    }
+}
+
+// каждый бит нагрузки и сдвига по отдельному слову, в обе стороны
+TEST(ItmoEndianTest, EverySingleBit) {
+    for (CodecKind kind : codecs()) {
+        for (int bit = 0; bit < 245; ++bit) {
+            uint239_limbs payload{{0, 0, 0, 0}};
+            payload.limb[bit / 64] = 1ull << (bit % 64);
+            uint8_t data[35];
+            pack_itmo(data, payload, 0, kind);
+            uint8_t expected[35] = {};
+            expected[34 - bit / 7] = 1 << (bit % 7);
+            ASSERT_EQ(memcmp(data, expected, 35), 0) << codec_name(kind) << " payload bit " << bit;
+        }
+        for (int bit = 0; bit < 35; ++bit) {
+            uint8_t data[35];
+            pack_itmo(data, uint239_limbs{{0, 0, 0, 0}}, 1ull << bit, kind);
+            uint8_t expected[35] = {};
+            expected[34 - bit] = 0x80;
+            ASSERT_EQ(memcmp(data, expected, 35), 0) << codec_name(kind) << " shift bit " << bit;
+        }
+    }
+}
+
+TEST(ItmoEndianTest, RandomWords) {
+    TestRandom random(239);
+    for (int t = 0; t < 100000; ++t) {
+        uint8_t data[35];
+        for (int i = 0; i < 35; ++i) {
+            data[i] = random.next() >> 56;
+        }
+        check_round_trip(data);
+    }
+}
+
+// лишние биты выше 245-го и 35-го при сборке не попадают в байты
+TEST(ItmoEndianTest, PackIgnoresHighBits) {
+    for (CodecKind kind : codecs()) {
+        uint8_t data[35];
+        pack_itmo(data, uint239_limbs{{0, 0, 0, ~0ull << 53}}, ~0ull << 35, kind);
+        for (int i = 0; i < 35; ++i) {
+            ASSERT_EQ(data[i], 0) << codec_name(kind) << " byte " << i;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include <lib/number.h>
+#include <gtest/gtest.h>
+
+#include "test_random.h"
+
+
+// переполнение считается при компиляции так же, как во время работы
+constexpr bool overflow_of(const uint239_t& a, const uint239_t& b) {
+    uint239_t result;
+    return mul_overflow(a, b, result);
+}
+
+static_assert(!overflow_of(FromInt(65536, 0), FromInt(65536, 0)));
+static_assert(!overflow_of(883423532389192164791648750371459257913741948437809479060803100646309887_u239, 1_u239));
+static_assert(overflow_of(883423532389192164791648750371459257913741948437809479060803100646309887_u239, 2_u239));
+// 2^120 * 2^118 = 2^238 ещё влезает, 2^120 * 2^119 = 2^239 уже нет
+static_assert(!overflow_of(1329227995784915872903807060280344576_u239, 332306998946228968225951765070086144_u239));
+static_assert(overflow_of(1329227995784915872903807060280344576_u239, 664613997892457936451903530140172288_u239));
+
+namespace {
+
+uint239_limbs random_limbs(TestRandom& random, int words) {
+    uint239_limbs value{{0, 0, 0, 0}};
+    for (int i = 0; i < words; ++i) {
+        value.limb[i] = random.next();
+    }
+    // иногда все единицы: на них ломаются переносы
+    if (words == 4 && random.next() % 5 == 0) {
+        value = uint239_limbs{{~0ull, ~0ull, ~0ull, 0}};
+    }
+    value.limb[3] &= (1ull << 53) - 1; // до 245 бит, как после DoShift
+    return value;
+}
+
+} // namespace
+
+
+TEST(MulTest, KaratsubaMatchesSchoolbook) {
+    TestRandom random(239);
+    for (int t = 0; t < 50000; ++t) {
+        uint239_limbs a = random_limbs(random, 1 + t % 4);
+        uint239_limbs b = random_limbs(random, 1 + (t / 4) % 4);
+        uint478_limbs full = limbs::mul_full(a, b);
+        uint478_limbs karatsuba = limbs::mul_full_karatsuba(a, b);
+        for (int k = 0; k < 8; ++k) {
+            ASSERT_EQ(full.limb[k], karatsuba.limb[k]) << "limb " << k << ", iteration " << t;
+        }
+        uint239_limbs low = limbs::truncate(full), truncated = limbs::mul(a, b);
+        for (int k = 0; k < 4; ++k) {
+            ASSERT_EQ(low.limb[k], truncated.limb[k]) << "limb " << k << ", iteration " << t;
+        }
+    }
+}
+
+TEST(MulTest, OverflowFlagAndResult) {
+    TestRandom random(30);
+    for (int t = 0; t < 20000; ++t) {
+        uint239_t a = FromLimbs(limbs::truncate(random_limbs(random, 1 + t % 4)), t);
+        uint239_t b = FromLimbs(limbs::truncate(random_limbs(random, 1 + (t / 4) % 4)), 3 * t);
+        uint239_t result;
+        bool overflow = mul_overflow(a, b, result);
+        ASSERT_EQ(memcmp(result.data, (a * b).data, 35), 0);
+        // без переполнения произведение делится обратно без остатка
+        if (!overflow && !(b == FromInt(0, 0))) {
+            ASSERT_EQ(result / b, a);
+        }
+        ASSERT_EQ(overflow, len(a) + len(b) > 240 || (len(a) + len(b) == 240 && !(result / b == a)));
+    }
+}
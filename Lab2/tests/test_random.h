@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <lib/number.h>
+
+// Общий генератор тестовых данных: LCG с перемешиванием старших бит, одинаковый seed - одинаковые числа.
+struct TestRandom {
+    uint64_t state;
+
+    explicit TestRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state ^ (state >> 31);
+    }
+
+    // значение из words слов по 64 бита, до 239 бит
+    uint239_limbs next_limbs(int words) {
+        uint239_limbs value{{0, 0, 0, 0}};
+        for (int i = 0; i < words; ++i) {
+            value.limb[i] = next();
+        }
+        return limbs::truncate(value);
+    }
+};
+
+// полноширинные числа разной длины и случайные сдвиги, каждое седьмое - ещё и после DoShift,
+// то есть с padding битами
+inline std::vector<uint239_t> random_numbers(size_t count, uint64_t seed) {
+    TestRandom random(seed);
+    std::vector<uint239_t> numbers(count);
+    for (size_t i = 0; i < count; ++i) {
+        numbers[i] = FromLimbs(random.next_limbs(1 + i % 4), random.next() % limbs::kShiftModulo);
+        if (i % 7 == 0) {
+            DoShift(numbers[i], int(random.next() % 600) - 300);
+        }
+    }
+    return numbers;
+}
@@ -0,0 +1,86 @@
+#include <lib/uint239_array.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "test_random.h"
+
+namespace {
+
+std::vector<ArrayKind> kinds() {
+    std::vector<ArrayKind> result = {ArrayKind::Scalar};
+    if (best_array_kind() == ArrayKind::Avx2) {
+        result.push_back(ArrayKind::Avx2);
+    }
+    return result;
+}
+
+void expect_same_bytes(const uint239_t& a, const uint239_t& b, size_t i, ArrayKind kind) {
+    ASSERT_EQ(memcmp(a.data, b.data, 35), 0) << "element " << i << ", " << array_kind_name(kind);
+}
+
+} // namespace
+
+
+class ArrayTestsSuite : public testing::TestWithParam<size_t> {
+};
+
+TEST_P(ArrayTestsSuite, LoadStoreRoundTrip) {
+    std::vector<uint239_t> numbers = random_numbers(GetParam(), 1);
+    for (ArrayKind kind : kinds()) {
+        uint239_array array(numbers.size());
+        load(array, numbers.data(), kind);
+        std::vector<uint239_t> back(numbers.size());
+        store(array, back.data(), kind);
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            expect_same_bytes(back[i], numbers[i], i, kind);
+            expect_same_bytes(array.get(i), numbers[i], i, kind);
+        }
+    }
+}
+
+TEST_P(ArrayTestsSuite, AddSubCompareLikeScalarOperators) {
+    std::vector<uint239_t> lhs = random_numbers(GetParam(), 2);
+    std::vector<uint239_t> rhs = random_numbers(GetParam(), 3);
+    for (size_t i = 0; i < lhs.size(); i += 7) {
+        rhs[i] = lhs[i]; // равные значения тоже должны встречаться
+    }
+    for (ArrayKind kind : kinds()) {
+        uint239_array a(lhs.size()), b(rhs.size()), sum(lhs.size()), diff(lhs.size());
+        load(a, lhs.data(), kind);
+        load(b, rhs.data(), kind);
+        add(a, b, sum, kind);
+        sub(a, b, diff, kind);
+        std::vector<int8_t> order(lhs.size());
+        compare(a, b, order.data(), kind);
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            expect_same_bytes(sum.get(i), lhs[i] + rhs[i], i, kind);
+            expect_same_bytes(diff.get(i), lhs[i] - rhs[i], i, kind);
+            ASSERT_EQ(order[i], (lhs[i] > rhs[i]) - (lhs[i] < rhs[i])) << "element " << i;
+        }
+
+        // результат на месте одного из аргументов
+        add(a, b, a, kind);
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            expect_same_bytes(a.get(i), lhs[i] + rhs[i], i, kind);
+        }
+    }
+}
+
+TEST_P(ArrayTestsSuite, DoShiftLikeScalar) {
+    std::vector<uint239_t> numbers = random_numbers(GetParam(), 4);
+    for (int shift : {0, 1, -1, 63, 64, 200, 244, 245, -1000, 12345}) {
+        for (ArrayKind kind : kinds()) {
+            uint239_array array(numbers.size());
+            load(array, numbers.data(), kind);
+            do_shift(array, shift, kind);
+            for (size_t i = 0; i < numbers.size(); ++i) {
+                uint239_t expected = numbers[i];
+                DoShift(expected, shift);
+                expect_same_bytes(array.get(i), expected, i, kind);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Group, ArrayTestsSuite, testing::Values(0, 1, 3, 4, 5, 64, 1003));
@@ -0,0 +1,156 @@
+#include <lib/number.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "test_random.h"
+
+
+static_assert(limbs::layout<127>::kBytes == 19 && limbs::layout<127>::kPayloadBits == 133);
+static_assert(limbs::layout<127>::kCount == 3 && limbs::layout<127>::kShiftBits == 19);
+static_assert(limbs::layout<239>::kBytes == 35 && limbs::layout<239>::kPayloadBits == 245);
+static_assert(limbs::layout<239>::kCount == 4 && limbs::layout<239>::kShiftBits == 35);
+static_assert(limbs::layout<511>::kBytes == 73 && limbs::layout<511>::kPayloadBits == 511);
+static_assert(limbs::layout<511>::kCount == 8 && limbs::layout<511>::kShiftBits == 73);
+static_assert(std::is_same_v<limbs::shift_t<239>, uint64_t>);
+static_assert(std::is_same_v<limbs::shift_t<511>, unsigned __int128>);
+
+// то же, что в constexpr_test.cpp, на других ширинах
+static_assert(FromInt<127>(1000, 0) + FromInt<127>(24, 0) == FromString<127>("1024", 0));
+static_assert(GetShift(FromInt<127>(1, 3) - FromInt<127>(1, 4)) == (1u << 19) - 1);
+static_assert(FromInt<511>(65536, 0) * FromInt<511>(65536, 0) == FromString<511>("4294967296", 0));
+static_assert(GetShift(FromInt<511>(1, 3) - FromInt<511>(1, 4)) == ((unsigned __int128) 1 << 73) - 1);
+static_assert(len(FromInt<511>(0, 0) - FromInt<511>(1, 0)) == 511);
+
+
+namespace {
+
+template<int Bits>
+std::string to_string(const uint_itmo_t<Bits>& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+template<int Bits>
+uint_limbs<Bits> random_limbs(TestRandom& random) {
+    uint_limbs<Bits> value{};
+    int words = 1 + random.next() % limbs::layout<Bits>::kCount;
+    for (int i = 0; i < words; ++i) {
+        value.limb[i] = random.next();
+    }
+    return limbs::truncate(value);
+}
+
+// разбор по одному биту, как он описан в условии
+template<int Bits>
+void unpack_reference(const uint8_t* data, uint_limbs<Bits>& payload, limbs::shift_t<Bits>& shift) {
+    constexpr int bytes = limbs::layout<Bits>::kBytes;
+    payload = uint_limbs<Bits>{};
+    shift = 0;
+    for (int i = 0; i < bytes; ++i) {
+        shift = (shift << 1) | (data[i] >> 7);
+        for (int j = 0; j < 7; ++j) {
+            int bit = 7 * (bytes - 1 - i) + j;
+            payload.limb[bit / 64] |= uint64_t((data[i] >> j) & 1) << (bit % 64);
+        }
+    }
+}
+
+template<int Bits>
+void check_codec(uint64_t seed) {
+    constexpr int bytes = limbs::layout<Bits>::kBytes;
+    TestRandom random(seed);
+    for (int t = 0; t < 2000; ++t) {
+        uint8_t data[bytes];
+        for (uint8_t& byte : data) {
+            byte = random.next();
+        }
+        // padding биты всегда нули
+        data[0] &= 0x80 | (0x7f >> (limbs::layout<Bits>::kPayloadBits - Bits));
+
+        uint_limbs<Bits> expected, payload;
+        limbs::shift_t<Bits> expected_shift, shift;
+        unpack_reference<Bits>(data, expected, expected_shift);
+        itmo_endian::unpack_portable(data, payload, shift);
+        ASSERT_TRUE(shift == expected_shift);
+        ASSERT_EQ(limbs::compare(payload, expected), 0);
+
+        uint8_t packed[bytes];
+        memset(packed, 0xa5, bytes);
+        itmo_endian::pack_portable(packed, payload, shift);
+        ASSERT_EQ(memcmp(packed, data, bytes), 0);
+    }
+}
+
+} // namespace
+
+
+TEST(WidthTest, CodecMatchesBitByBit) {
+    check_codec<127>(127);
+    check_codec<239>(239);
+    check_codec<511>(511);
+}
+
+// uint127_t сверяется с unsigned __int128 по модулю 2^127
+TEST(WidthTest, Uint127MatchesInt128) {
+    const unsigned __int128 mask = ~(unsigned __int128) 0 >> 1;
+    TestRandom random(127);
+    for (int t = 0; t < 20000; ++t) {
+        uint_limbs<127> a = random_limbs<127>(random), b = random_limbs<127>(random);
+        unsigned __int128 x = a.limb[0] | (unsigned __int128) a.limb[1] << 64;
+        unsigned __int128 y = b.limb[0] | (unsigned __int128) b.limb[1] << 64;
+        uint127_t lhs = FromLimbs(a, random.next()), rhs = FromLimbs(b, random.next());
+
+        auto check = [](const uint127_t& value, unsigned __int128 expected) {
+            uint_limbs<127> v = ToLimbs(value);
+            ASSERT_EQ(v.limb[0], (uint64_t) expected);
+            ASSERT_EQ(v.limb[1], (uint64_t) (expected >> 64));
+            ASSERT_EQ(v.limb[2], 0u);
+        };
+        check(lhs + rhs, (x + y) & mask);
+        check(lhs - rhs, (x - y) & mask);
+        check(lhs * rhs, (x * y) & mask);
+        if (y != 0) {
+            check(lhs / rhs, x / y);
+        }
+        ASSERT_EQ(lhs < rhs, x < y);
+        ASSERT_EQ(GetShift(lhs + rhs), (GetShift(lhs) + GetShift(rhs)) % (1u << 19));
+    }
+}
+
+TEST(WidthTest, Uint511Identities) {
+    TestRandom random(511);
+    for (int t = 0; t < 5000; ++t) {
+        uint511_t a = FromLimbs(random_limbs<511>(random), t);
+        uint511_t b = FromLimbs(random_limbs<511>(random), 3 * t);
+        ASSERT_EQ((a + b) - b, a);
+        ASSERT_EQ(FromString<511>(to_string(a).c_str(), 0), a);
+
+        uint511_t product;
+        if (!mul_overflow(a, b, product) && len(b) > 0) {
+            ASSERT_EQ(product / b, a);
+        }
+    }
+}
+
+TEST(WidthTest, PrintAndShift) {
+    uint511_t top = FromInt<511>(1, 0);
+    DoShift(top, 510);
+    ASSERT_EQ(to_string(top), "33519519824856492748935062495514615318698414551480983444308903609304410075183867442004685745"
+                              "41725856922507964546621512713438470702986642486608412251521024");
+    ASSERT_EQ(to_string(FromInt<511>(0, 0) - FromInt<511>(1, 0)),
+              "67039039649712985497870124991029230637396829102961966888617807218608820150367734884009371490"
+              "83451713845015929093243025426876941405973284973216824503042047");
+
+    // 73 бита сдвига: больше, чем в uint64_t
+    unsigned __int128 shift = ((unsigned __int128) 1 << 72) + 5;
+    ASSERT_TRUE(GetShift(SetShift(top, shift)) == shift);
+    ASSERT_EQ(SetShift(top, shift), top);
+
+    // у uint127_t 133 бита нагрузки, после DoShift значение длиннее 127 бит
+    uint127_t a = FromInt<127>(1, 0);
+    DoShift(a, -1);
+    ASSERT_EQ(to_string(a), "5444517870735015415413993718908291383296");
+}
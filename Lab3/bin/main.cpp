@@ -7,154 +7,163 @@
 #include <unordered_map>
 
 
-     
+
+// Поле одним куском памяти: строки по stride ячеек подряд, вокруг занятой части width x height
+// запас со всех четырёх сторон, заполненный нулями. Клетка (0, 0) лежит в cells[top * stride + left],
+// поэтому push_left/push_top только сдвигают начало, а push_right/push_down увеличивают размер.
+// Когда запас с какой-то стороны кончается, буфер перевыделяется с запасом в половину размера
+// с каждой стороны, так что рост в любую сторону - амортизированно O(1) на строку/столбец.
+// Рядом с клетками - битовая маска неустойчивых клеток (4 песчинки и больше) той же раскладки
+// и число таких клеток в каждой строке, чтобы updater не перебирал всё поле.
+template<typename Cell>
 struct vec {
-    int real_height = 0;
-    int fake_height = 0;
-    int real_width = 0;
-    int fake_width = 1;
-    int **data;
-
-    vec(int height = 0, int width = 0)
-            : fake_height(height), fake_width(width),
-              real_height(height), real_width(width),
-              data(nullptr) {
-        if (height > 0 && width > 0) {
-            data = new int *[height];
-            for (int i = 0; i < height; ++i) {
-                data[i] = new int[width];
-                for (int j = 0; j < width; ++j) {
-                    data[i][j] = 0;
-                }
-            }
-        }
+    int width = 0;
+    int height = 0;
+    int stride = 0; // выделено ячеек в строке
+    int rows = 0;   // выделено строк
+    int left = 0;   // где в буфере начинается занятая часть
+    int top = 0;
+    Cell *cells = nullptr;
+    int words = 0;                  // слов маски на строку
+    uint64_t *unstable = nullptr;   // бит x строки y - клетка cells[y * stride + x] неустойчива
+    int *unstable_in_row = nullptr;
+
+    vec(int height = 0, int width = 0) {
+        regrow(height, width);
     }
 
     ~vec() {
-        if (data) {
-            for (int i = 0; i < fake_height; ++i) {
-                delete[] data[i];
-            }
-            delete[] data;
+        delete[] cells;
+        delete[] unstable;
+        delete[] unstable_in_row;
+    }
+
+    vec(const vec &) = delete;
+    vec &operator=(const vec &) = delete;
+
+    vec &operator=(vec &&other) {
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        std::swap(stride, other.stride);
+        std::swap(rows, other.rows);
+        std::swap(left, other.left);
+        std::swap(top, other.top);
+        std::swap(cells, other.cells);
+        std::swap(words, other.words);
+        std::swap(unstable, other.unstable);
+        std::swap(unstable_in_row, other.unstable_in_row);
+        return *this;
+    }
+
+    static int margin(int size) {
+        return size / 2 + 16;
+    }
+
+    // новый буфер под new_height x new_width с запасом по краям, старое содержимое копируется
+    void regrow(int new_height, int new_width) {
+        int new_left = margin(new_width), new_top = margin(new_height);
+        int new_stride = new_width + 2 * new_left, new_rows = new_height + 2 * new_top;
+        Cell *new_cells = new Cell[(size_t) new_stride * new_rows]();
+        for (int y = 0; y < height; ++y) {
+            memcpy(new_cells + (size_t) (new_top + y) * new_stride + new_left, row(y), width * sizeof(Cell));
         }
+        delete[] cells;
+        cells = new_cells;
+        stride = new_stride;
+        rows = new_rows;
+        left = new_left;
+        top = new_top;
+        width = new_width;
+        height = new_height;
+        find_unstable();
     }
 
-    void resize_up() {
-        fake_height *= 2;
-        int **new_data = new int *[fake_height];
-        for (int i = 0; i < fake_height; ++i) {
-            new_data[i] = new int[fake_width];
-            for (int j = 0; j < fake_width; ++j) {
-                new_data[i][j] = 0;
+    // маска заново по всем клеткам: после перевыделения и после заполнения из tsv
+    void find_unstable() {
+        delete[] unstable;
+        delete[] unstable_in_row;
+        words = (stride + 63) / 64;
+        unstable = new uint64_t[(size_t) words * rows]();
+        unstable_in_row = new int[rows]();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (at(y, x) >= 4) {
+                    set_unstable(top + y, left + x);
+                }
             }
         }
-        for (int i = 0; i < real_height; ++i) {
-            for (int j = 0; j < real_width; ++j) {
-                new_data[i][j] = data[i][j];
-            }
+    }
 
-        }
-        for (int i = 0; i < fake_height / 2; ++i) {
-            delete[] data[i];
-        }
-        delete[] data;
-        data = new_data;
+    // r, c - строка и столбец в буфере, а не в занятой части; бит должен быть сброшен
+    void set_unstable(int r, int c) {
+        unstable[(size_t) r * words + c / 64] |= 1ull << (c % 64);
+        unstable_in_row[r]++;
     }
 
-    void resize_left() {
-        fake_width *= 2;
-        for (int j = 0; j < fake_height; ++j) {
-            int *new_data = new int[fake_width];
-            for (int i = 0; i < fake_width; ++i) {
-                new_data[i] = 0;
-            }
-            for (int i = 0; i < real_width; ++i) {
-                new_data[i] = data[j][i];
+    // бит должен быть выставлен
+    void clear_unstable(int r, int c) {
+        unstable[(size_t) r * words + c / 64] &= ~(1ull << (c % 64));
+        unstable_in_row[r]--;
+    }
+
+    // первая неустойчивая клетка строки y не левее x, -1 если таких нет
+    int next_unstable(int y, int x) {
+        int r = top + y, c = left + x;
+        if (unstable_in_row[r] == 0) {
+            return -1;
+        }
+        const uint64_t *line = unstable + (size_t) r * words;
+        int w = c / 64;
+        if (w >= words) {
+            return -1;
+        }
+        uint64_t word = line[w] & (~0ull << (c % 64));
+        while (word == 0) {
+            if (++w == words) {
+                return -1;
             }
-            delete[] data[j];
-            data[j] = new_data;
-            //delete[] new_data;
+            word = line[w];
         }
+        return w * 64 + __builtin_ctzll(word) - left;
+    }
+
+    Cell *row(int y) {
+        return cells + (size_t) (top + y) * stride + left;
+    }
+
+    Cell &at(int y, int x) {
+        return row(y)[x];
     }
 
     void push_right() {
-        if (real_width == fake_width) {
-            resize_left();
-        }
-        for (int i = 0; i < real_height; ++i) {
-            data[i][real_width] = 0;
+        if (left + width == stride) {
+            regrow(height, width);
         }
-        real_width++;
+        width++;
     }
 
     void push_left() {
-        if (real_width == fake_width) {
-            resize_left();
-        }
-
-        for (int i = 0; i < real_height; ++i) {
-            for (int j = real_width; j > 0; --j) {
-                data[i][j] = data[i][j - 1];
-            }
-            data[i][0] = 0;
+        if (left == 0) {
+            regrow(height, width);
         }
-        real_width++;
+        left--;
+        width++;
     }
 
     void push_down() {
-        if (real_height == fake_height) {
-            resize_up();
-        }
-        for (int i = 0; i < fake_width; ++i) {
-            data[real_height][i] = 0;
+        if (top + height == rows) {
+            regrow(height, width);
         }
-        real_height++;
+        height++;
     }
 
     void push_top() {
-        if (real_height == fake_height) {
-            resize_up();
+        if (top == 0) {
+            regrow(height, width);
         }
-        for (int i = real_height; i > 0; --i) {
-            data[i] = data[i - 1];
-        }
-        data[0] = new int[fake_width];
-        for (int i = 0; i < fake_width; ++i) {
-            data[0][i] = 0;
-        }
-        real_height++;
+        top--;
+        height++;
     }
-
-    vec &operator=(const vec &other) {
-        if (this != &other) {
-            if (data) {
-                for (int i = 0; i < real_height; ++i) {
-                    delete[] data[i];
-                }
-                delete[] data;
-            }
-
-            real_height = other.real_height;
-            real_width = other.real_width;
-            fake_height = other.fake_height;
-            fake_width = other.fake_width;
-
-            data = new int *[fake_height];
-            for (int i = 0; i < fake_height; ++i) {
-                data[i] = new int[fake_width];
-                for (int j = 0; j < fake_width; ++j) {
-                    if (i < real_height && j < real_width) {
-                        data[i][j] = other.data[i][j];
-                    } else {
-                        data[i][j] = 0;
-                    }
-                }
-            }
-
-        }
-        return *this;
-    }
-
 };
 
 struct paths {
@@ -182,12 +191,16 @@ struct paths {
     }
 };
 
-struct pole {
+struct pole_settings {
     int width = 0;
     int height = 0;
     int frequency = 0;
     int counter = 0;
-    vec pol;
+};
+
+template<typename Cell>
+struct pole : pole_settings {
+    vec<Cell> pol;
 
     pole() : pol(10, 10) {
 
@@ -196,78 +209,77 @@ struct pole {
     void init(int w = 1, int h = 1) {
         width = w;
         height = h;
-        pol = vec(h, w);
+        pol = vec<Cell>(h, w);
     }
 
 };
 
-void read(pole &pole, paths &file_paths) {
+// первый проход по tsv: границы поля и самая большая кучка
+struct tsv_bounds {
+    int min_x = 1e9, min_y = 1e9;
+    int max_x = -1e9, max_y = -1e9;
+    uint64_t max_color = 0;
+};
+
+// строка "x y количество"
+void parse_line(char *line, int &x, int &y, uint64_t &color) {
+    char *token = strtok(line, " ");
+    int i = 0;
+    while (token != nullptr) {
+        if (i == 0) {
+            x = atoi(token);
+        }
+        if (i == 1) {
+            y = atoi(token);
+        }
+        if (i == 2) {
+            color = strtoull(token, nullptr, 10);
+        }
+        token = strtok(nullptr, " ");
+        i++;
+    }
+}
+
+bool scan(tsv_bounds &bounds, paths &file_paths) {
 
     std::ifstream file(file_paths.input_fl_tsv);
 
     if (!file.is_open()) {
         printf("error reading tsv1");
-        return;
+        return false;
     }
     char line[100];
-    int i = 0;
-    int x, y, color;
-    int min_x = 1e9, min_y = 1e9;
-    int max_x = -1e9, max_y = -1e9;
+    int x, y;
+    uint64_t color;
     while (file.getline(line, sizeof(line))) {
-        char *token = strtok(line, " ");
-        i = 0;
-        while (token != nullptr) {
-            if (i == 0) {
-                x = atoi(token);
-            }
-            if (i == 1) {
-                y = atoi(token);
-            }
-            if (i == 2) {
-                color = atoi(token);
-            }
-            token = strtok(nullptr, " ");
-            i++;
-        }
-        min_x = std::min(min_x, x);
-        min_y = std::min(min_y, y);
-        max_x = std::max(max_x, x);
-        max_y = std::max(max_y, y);
+        parse_line(line, x, y, color);
+        bounds.min_x = std::min(bounds.min_x, x);
+        bounds.min_y = std::min(bounds.min_y, y);
+        bounds.max_x = std::max(bounds.max_x, x);
+        bounds.max_y = std::max(bounds.max_y, y);
+        bounds.max_color = std::max(bounds.max_color, color);
     }
-    file.close();
+    return true;
+}
 
+template<typename Cell>
+void read(pole<Cell> &pole, const tsv_bounds &bounds, paths &file_paths) {
     std::ifstream file2(file_paths.input_fl_tsv);
     if (!file2.is_open()) {
         printf("error reading tsv2");
         return;
     }
     char line2[100];
-    i = 0;
-    x, y, color;
+    int x, y;
+    uint64_t color;
 
-    pole.init(max_x - (min_x) + 100, max_y - (min_y) + 100);
-    //std::cout << max_x - (min_x) + 300 << ' ';
+    pole.init(bounds.max_x - (bounds.min_x) + 100, bounds.max_y - (bounds.min_y) + 100);
     while (file2.getline(line2, sizeof(line2))) {
-        char *token = strtok(line2, " ");
-        i = 0;
-        while (token != nullptr) {
-            if (i == 0) {
-                x = atoi(token);
-            }
-            if (i == 1) {
-                y = atoi(token);
-            }
-            if (i == 2) {
-                color = atoi(token);
-            }
-            token = strtok(nullptr, " ");
-            i++;
-        }
-        //std::cout << pole.width;
-        pole.pol.data[y - min_y + 99][x - min_x + 99] = color;
+        parse_line(line2, x, y, color);
+        pole.pol.at(y - bounds.min_y + 99, x - bounds.min_x + 99) = color;
     }
     file2.close();
+    pole.pol.find_unstable();
 
 
 }
@@ -299,7 +311,8 @@ struct DIBHeader {
 int f = 0;
 #pragma pack(pop)
 
-void createColoredRectangleBMP(std::string filename, int width, int height, pole &a) {
+template<typename Cell>
+void createColoredRectangleBMP(std::string filename, int width, int height, pole<Cell> &a) {
     std::ofstream bmpFile(std::to_string(f) + filename, std::ios::binary);
     BMPHeader bmpHeader;
     DIBHeader dibHeader;
@@ -356,9 +369,9 @@ void createColoredRectangleBMP(std::string filename, int width, int height, pole
         for (int x = 0; x < width; ++x) {
             int index = (y * rowSize) + (x / 2);
             if (x % 2 == 0) {
-                imageData[index] |= (a.pol.data[y][x]) << 4;
+                imageData[index] |= (a.pol.at(y, x)) << 4;
             } else {
-                imageData[index] |= (a.pol.data[y][x]);
+                imageData[index] |= (a.pol.at(y, x));
             }
         }
     }
@@ -371,50 +384,66 @@ void createColoredRectangleBMP(std::string filename, int width, int height, pole
 }
 
 
-bool updater(pole &pole, paths &paths) {
+// Один проход по полю в том же порядке, что и раньше (по строкам сверху вниз, в строке слева
+// направо), но только по неустойчивым клеткам из маски. Клетки справа и снизу, ставшие
+// неустойчивыми, обрабатываются в этом же проходе, слева и сверху - в следующем, как при полном
+// переборе, поэтому картинки с -f и обрыв по -m те же. Работа - по числу обрушений и строк, а не клеток.
+template<typename Cell>
+bool updater(pole<Cell> &pole, paths &paths) {
     bool ans = false;
     int update_left = 0, update_right = 0, update_top = 0, update_down = 0;
-    for (int i = 0; i < pole.height; i++) {
-        for (int j = 0; j < pole.width; j++) {
-            int ii = i + update_top;
-            int jj = j + update_left;
-            if (pole.pol.data[ii][jj] < 4) {
-                continue;
-            }
-            if (ii == 0 && update_top == 0) {
-                pole.pol.push_top();
+    vec<Cell> &pol = pole.pol;
+    for (int ii = 0; ii < pol.height; ii++) {
+        for (int jj = pol.next_unstable(ii, 0); jj >= 0; jj = pol.next_unstable(ii, jj + 1)) {
+            int y = ii, x = jj; // координаты до расширения поля на этой клетке
+            if (y == 0 && update_top == 0) {
+                pol.push_top();
                 update_top = 1;
+                ii++;
             }
 
-            if (ii == pole.height - 1 && update_down == 0) {
-                pole.pol.push_down();
+            if (y == pole.height - 1 && update_down == 0) {
+                pol.push_down();
                 update_down = 1;
             }
 
-            if (jj == 0 && update_left == 0) {
-                pole.pol.push_left();
+            if (x == 0 && update_left == 0) {
+                pol.push_left();
                 update_left = 1;
+                jj++;
             }
 
 
-            if (jj == pole.width - 1 && update_right == 0) {
-                pole.pol.push_right();
+            if (x == pole.width - 1 && update_right == 0) {
+                pol.push_right();
                 update_right = 1;
             }
 
 
-            ii = i + update_top;
-            jj = j + update_left;
-            pole.pol.data[ii][jj] -= 4;
+            Cell *cell = &pol.at(ii, jj);
+            *cell -= 4;
             if (pole.frequency != 0 && pole.counter % pole.frequency == 0) {
                 f++;
                 createColoredRectangleBMP(paths.output_fl_bmp, pole.width, pole.height, pole);
             }
 
-            pole.pol.data[ii - 1][jj]++;
-            pole.pol.data[ii][jj - 1]++;
-            pole.pol.data[ii + 1][jj]++;
-            pole.pol.data[ii][jj + 1]++;
+            // соседи становятся неустойчивыми ровно тогда, когда в них стало 4
+            int r = pol.top + ii, c = pol.left + jj;
+            if (*cell < 4) {
+                pol.clear_unstable(r, c);
+            }
+            if (++cell[-pol.stride] == 4) {
+                pol.set_unstable(r - 1, c);
+            }
+            if (++cell[-1] == 4) {
+                pol.set_unstable(r, c - 1);
+            }
+            if (++cell[pol.stride] == 4) {
+                pol.set_unstable(r + 1, c);
+            }
+            if (++cell[1] == 4) {
+                pol.set_unstable(r, c + 1);
+            }
             pole.counter--;
 
             ans = true;
@@ -426,7 +455,7 @@ bool updater(pole &pole, paths &paths) {
     return ans;
 }
 
-bool ReadArgs(int argc, char *argv[], pole &pole, paths &paths) {
+bool ReadArgs(int argc, char *argv[], pole_settings &pole, paths &paths) {
     //std::cout << argc << ' ';
     for (int i = 1; i < argc; ++i) {
         //std::cout << i << ' ' << argv[i] << ' ';
@@ -470,21 +499,40 @@ bool ReadArgs(int argc, char *argv[], pole &pole, paths &paths) {
     return true;
 }
 
+template<typename Cell>
+void run(const pole_settings &settings, const tsv_bounds &bounds, paths &paths) {
+    pole<Cell> pol;
+    static_cast<pole_settings &>(pol) = settings;
+    read(pol, bounds, paths);
+
+    std::cout << pol.counter << std::endl;
+    while (pol.counter > 0 && updater(pol, paths)) {}
+    std::cout << pol.width << std::endl;
+    createColoredRectangleBMP(paths.output_fl_bmp, pol.width, pol.height, pol);
+}
+
 int main(int argc, char *argv[]) {
-    //std::vector<std::vector<int>>a;
-    //a.assign(200, std::vector<int>(100,2));
-    pole pol;
+    pole_settings settings;
     paths paths;
-    if (!ReadArgs(argc, argv, pol, paths)) {
+    if (!ReadArgs(argc, argv, settings, paths)) {
         printf("logs error");
         return 0;
     }
     //a.exe -i = pole.tsv -o = img.bmp -m = 10000000
-    read(pol, paths);
+    tsv_bounds bounds;
+    if (!scan(bounds, paths)) {
+        return 0;
+    }
 
-    std::cout << pol.counter << std::endl;
-    while (pol.counter > 0 && updater(pol, paths)) {}
-    std::cout << pol.width << std::endl;
-    createColoredRectangleBMP(paths.output_fl_bmp, pol.width, pol.height, pol);
+    // клетка больше не становится больше max(начальное, 7) + 4: за проход она получает не больше
+    // 4 песчинок и, если в ней 4 и больше, отдаёт 4. Поэтому обычно хватает 1 байта на клетку,
+    // а uint64_t нужен только для огромных начальных кучек
+    if (bounds.max_color + 8 <= UINT8_MAX) {
+        run<uint8_t>(settings, bounds, paths);
+    } else if (bounds.max_color + 8 <= UINT16_MAX) {
+        run<uint16_t>(settings, bounds, paths);
+    } else {
+        run<uint64_t>(settings, bounds, paths);
+    }
     return 0;
 }